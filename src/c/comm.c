@@ -7,143 +7,430 @@
 #include "misc.h"
 
 #include "comm.h"
+#include "data/History.h"
 #include "data/Model.h"
-#include "libs/RingBuffer.h"
+#include "data/Rollup.h"
+#include "libs/PublishGate.h"
+#include "libs/SlotQueue.h"
 
 
 static Model* dataModel;
 static CommHandlers commHandlers;
-static RingBuffer* sendBuffer;
-static ClaySettings settings;
-static char** strSettings;
+static SlotQueue* sendBuffer;
+static ClaySettings settings;      ///< settings as last read from or written to persistent storage
+static AppTimer* settingsWriteTimer;
 static AppTimer* sendRetryTimer;
+static AppTimer* updateTimer;
 static uint8_t sendRetryCount;
+static uint8_t inFlightCount;    ///< number of messages at the head of sendBuffer awaiting an ack
 static bool pebkitReady;
-
-const uint8_t MAX_SEND_RETRIES = 5;
+static bool phoneConnected;      ///< false pauses the send queue until the phone reconnects
+
+// Focus tracking. View updates are suspended while something covers the app.
+static bool appInFocus;
+static PublishGate* focusGate;   ///< holds back the Model changes made while out of focus
+
+// A buffered message. The slot owns a copy of the payload, so callers may
+// reuse or free their own buffers as soon as comm_enqMsg returns.
+typedef struct MsgSlot {
+  uint32_t     key;
+  MessageType  type;
+  uint16_t     length;                          ///< bytes of payload in use
+  uint8_t      payload[COMM_MSG_PAYLOAD_SZ];    ///< string, integer or data bytes
+} MsgSlot;
+
+// Model change subscribers
+#define MAX_SUBSCRIBERS 4
+typedef struct Subscriber {
+  ModelChangeHandler handler;
+  Model_FieldMask    interest;
+} Subscriber;
+static Subscriber subscribers[MAX_SUBSCRIBERS];
+static Model_Generations seenGenerations;
+
+// Budget alarms
+static uint32_t budgetStep;               ///< whole currency units between alarms; 0 for none
+static uint64_t budgetNextMilliCost;      ///< the next cost to alarm at, in thousandths; 0 if none
+static AppTimer* budgetTimer;
+
+// Completed meetings
+static History* meetingHistory;
+static Rollup* meetingRollup;     ///< totals of the meetings by day, week and month
+
+// AppMessage buffer sizes. The build works them out per platform from the
+// message schema in package.json; these fallbacks only cover other builds.
+#ifndef COMM_INBOX_SIZE
+#define COMM_INBOX_SIZE 300
+#endif
+#ifndef COMM_OUTBOX_SIZE
+#define COMM_OUTBOX_SIZE 300
+#endif
+
+const uint8_t MAX_SEND_RETRIES = 7;
+// Retry delays double from the base up to the cap; each is then jittered
+const uint16_t SEND_RETRY_BASE_MS = 250;
+const uint16_t SEND_RETRY_MAX_MS = 8000;
 const uint8_t SEND_BUF_SIZE = 10;
 const uint32_t SETTINGS_STRUCT_KEY = 0x1000;
+// Settings writes wait this long for further changes, to save flash wear
+const uint16_t SETTINGS_WRITE_DELAY_MS = 3000;
+
+// Settings layout before SETTINGS_VER 2: no version set (0), natural
+// alignment, and the currency symbol in its own string key.
+typedef struct LegacySettings {
+  uint8_t  settingsVer;
+  uint32_t defaultMilliHourly;
+} LegacySettings;
+const uint32_t LEGACY_CURRENCY_SYMBOL_KEY = 0;
+const uint32_t CHECKPOINT_KEY = 0x1001;
+// Identifies the wakeup that stands in for the budget timer while the app is closed
+const int32_t BUDGET_WAKEUP_COOKIE = 0x42;
+// Extra delay past a visible change, so the wall clock has surely ticked over when the timer fires
+const uint16_t UPDATE_TIMER_SLACK_MS = 20;
+// Longest the budget timer is armed for; a later alarm is reached in steps of
+// this, which also keeps the delay in milliseconds well within 32 bits
+const uint32_t BUDGET_TIMER_MAX_SECS = 3600;
 
 
 /////////////////////////////////////////////////////////////////////////////
+/// Copies a message, payload and all, into a queue slot.
+/// @param[out]     slot  Slot to fill in
+/// @param[in]      msg  Message to copy
+/// @return  MPA_SUCCESS on success
+///          MPA_INVALID_INPUT_ERR if the message type is unknown or its
+///            payload doesn't fit in a slot (the slot is unchanged)
 /////////////////////////////////////////////////////////////////////////////
-static Message* comm_msg_create(uint32_t msgKey, void* payload) {
-  Message* newMsg = malloc(sizeof(*newMsg));
-  if (newMsg == NULL) return NULL;
+static MagPebApp_ErrCode comm_fillSlot(MsgSlot* slot, const Message* msg) {
+  MPA_RETURN_IF_NULL(slot);
+  MPA_RETURN_IF_NULL(msg);
+
+  const void* src = NULL;
+  size_t length = 0;
+  switch (msg->type) {
+    case MSG_TYPE_CSTRING: {
+      if (msg->payload.cstring == NULL) return MPA_NULL_POINTER_ERR;
+      src = msg->payload.cstring;
+      length = strlen(msg->payload.cstring) + 1;
+      break;
+    }
+    case MSG_TYPE_INT32:   { src = &msg->payload.int32;  length = sizeof(msg->payload.int32);  break; }
+    case MSG_TYPE_UINT32:  { src = &msg->payload.uint32; length = sizeof(msg->payload.uint32); break; }
+    case MSG_TYPE_DATA: {
+      if ( (msg->payload.data.bytes == NULL) && (msg->payload.data.length > 0) ) return MPA_NULL_POINTER_ERR;
+      src = msg->payload.data.bytes;
+      length = msg->payload.data.length;
+      break;
+    }
+    default: return MPA_INVALID_INPUT_ERR;
+  }
+  if (length > COMM_MSG_PAYLOAD_SZ) return MPA_INVALID_INPUT_ERR;
 
-  newMsg->key = msgKey;
-  newMsg->payload = payload;
-  return newMsg;
+  slot->key = msg->key;
+  slot->type = msg->type;
+  slot->length = (uint16_t)length;
+  if (length > 0) memcpy(slot->payload, src, length);
+  return MPA_SUCCESS;
 }
 
 
 /////////////////////////////////////////////////////////////////////////////
+/// Writes a message to an outbox dictionary as a tuple of its own type.
 /////////////////////////////////////////////////////////////////////////////
-static void comm_msg_destroy(Message* msg) {
-  if (msg != NULL) { free(msg); msg = NULL; }
+static DictionaryResult comm_writeMsg(DictionaryIterator* outIter, const Message* msg) {
+  switch (msg->type) {
+    case MSG_TYPE_CSTRING:  return dict_write_cstring(outIter, msg->key, msg->payload.cstring);
+    case MSG_TYPE_INT32:    return dict_write_int32(outIter, msg->key, msg->payload.int32);
+    case MSG_TYPE_UINT32:   return dict_write_uint32(outIter, msg->key, msg->payload.uint32);
+    case MSG_TYPE_DATA:     return dict_write_data(outIter, msg->key, msg->payload.data.bytes, msg->payload.data.length);
+    default: {
+      APP_LOG(APP_LOG_LEVEL_ERROR, "Unknown message type: %d", (int)msg->type);
+      return DICT_INVALID_ARGS;
+    }
+  }
 }
 
 
 /////////////////////////////////////////////////////////////////////////////
-/// Converts a tuple to a simple data type.
+/// Writes a buffered message to an outbox dictionary.
 /////////////////////////////////////////////////////////////////////////////
-static bool unloadTupleStr(char** buffer, size_t bufsize, Tuple* tuple, const char* readable) {
-  if (*buffer == NULL) {
-    APP_LOG(APP_LOG_LEVEL_ERROR, "unloadTupleStr: Cannot write to null buffer!");
-    return false;
+static DictionaryResult comm_writeSlot(DictionaryIterator* outIter, const MsgSlot* slot) {
+  Message msg = { .key = slot->key, .type = slot->type };
+  switch (slot->type) {
+    case MSG_TYPE_CSTRING:  msg.payload.cstring = (const char*)slot->payload;  break;
+    case MSG_TYPE_INT32:    memcpy(&msg.payload.int32, slot->payload, sizeof(msg.payload.int32));  break;
+    case MSG_TYPE_UINT32:   memcpy(&msg.payload.uint32, slot->payload, sizeof(msg.payload.uint32));  break;
+    case MSG_TYPE_DATA:     msg.payload.data.bytes = slot->payload;  msg.payload.data.length = slot->length;  break;
+    default: break;
+  }
+  return comm_writeMsg(outIter, &msg);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Queues a binary snapshot of the meeting state for the phone.
+/////////////////////////////////////////////////////////////////////////////
+static void comm_sendModelSnapshot() {
+  uint8_t snapshotBuf[MODEL_SNAPSHOT_SZ];
+  MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
+
+  if ( (mpaRet = Model_packSnapshot(dataModel, snapshotBuf, sizeof(snapshotBuf))) != MPA_SUCCESS) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Could not pack model snapshot: %s", MagPebApp_getErrMsg(mpaRet));
+    return;
   }
-  if (tuple != NULL) {
-    long ret = 0;
-    if ((ret = snprintf(*buffer, bufsize, "%s", tuple->value->cstring)) < 0) {
-      APP_LOG(APP_LOG_LEVEL_ERROR, "%s string was not written correctly. Ret=%ld", readable, ret);
-      return false;
-    } else if ((size_t)ret >= bufsize) {
-      APP_LOG(APP_LOG_LEVEL_WARNING, "%s string was truncated. %ld characters required.", readable, ret);
+
+  // A fresh snapshot supersedes anything older, so make room for it.
+  comm_enqMsg(&(Message) {
+    .key = MESSAGE_KEY_MODEL_SNAPSHOT,
+    .type = MSG_TYPE_DATA,
+    .payload.data = { .bytes = snapshotBuf, .length = sizeof(snapshotBuf) }
+  }, SLOTQUEUE_DROP_OLDEST);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Notifies each subscriber of the fields it is interested in, if any of
+/// them changed.
+/// @param[in]      changed  Mask of the fields that changed
+/////////////////////////////////////////////////////////////////////////////
+static void comm_notifySubscribers(const Model_FieldMask changed) {
+  if ( (dataModel == NULL) || (changed == 0) ) return;
+
+  for (int idx=0; idx<MAX_SUBSCRIBERS; idx++) {
+    if ( (subscribers[idx].handler != NULL) && ((subscribers[idx].interest & changed) != 0) ) {
+      (*subscribers[idx].handler)(dataModel, subscribers[idx].interest & changed);
     }
-    APP_LOG(APP_LOG_LEVEL_DEBUG, "unloadTupleStr %s: %s", readable, *buffer);
-    return true;
   }
-  return false;
 }
 
 
 /////////////////////////////////////////////////////////////////////////////
-/// Converts a tuple to a simple data type.
+/// Works out which Model fields changed since the last notification, and
+/// notifies the subscribers interested in them. While the app is out of
+/// focus nothing is drawn: the changes are held back, and published all at
+/// once when focus returns.
 /////////////////////////////////////////////////////////////////////////////
-static bool unloadTupleLong(long int* buffer, Tuple* tuple, const char* readable) {
-  if (tuple) {
-    *buffer = (long int)tuple->value->int32;
-    APP_LOG(APP_LOG_LEVEL_DEBUG, "unloadTupleLong %s: %ld", readable, *buffer);
-    return true;
+static void comm_publishChanges() {
+  MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
+  Model_FieldMask changed = 0;
+
+  if ( (mpaRet = Model_getChanges(dataModel, &seenGenerations, &changed)) != MPA_SUCCESS) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Error reading model changes: %s", MagPebApp_getErrMsg(mpaRet));
+    return;
+  }
+  uint32_t publish = changed;
+  if ( (mpaRet = PublishGate_pass(focusGate, changed, &publish)) != MPA_SUCCESS) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Error passing model changes: %s", MagPebApp_getErrMsg(mpaRet));
+  }
+  comm_notifySubscribers((Model_FieldMask)publish);
+
+  // Keep the phone in step with meeting state transitions. (It can run the
+  // cost forward itself from the rate in the snapshot.)
+  if (changed & (MODEL_FIELD_BIT(MODEL_FIELD_ATTENDEES) | MODEL_FIELD_BIT(MODEL_FIELD_STATUS))) {
+    comm_sendModelSnapshot();
   }
-  return false;
 }
 
 
 /////////////////////////////////////////////////////////////////////////////
-/// Handles callbacks from the JS component
+/// Decides what to do about a failed send, by reason. Failures that retrying
+/// can't fix soon pause the queue until an event resumes it; the rest back
+/// off and retry.
+/// @param[in]      reason  Result reported by AppMessage
 /////////////////////////////////////////////////////////////////////////////
-static void inbox_received_callback(DictionaryIterator *iterator, void *context) {
-  APP_LOG(APP_LOG_LEVEL_INFO, "Inbox receive successful.");
+static void comm_handleSendFailure(const AppMessageResult reason) {
+  switch (reason) {
+    case APP_MSG_NOT_CONNECTED: {
+      // No phone. comm_connectionHandler resumes sending on reconnect.
+      APP_LOG(APP_LOG_LEVEL_WARNING, "Phone not connected. Pausing the send queue.");
+      phoneConnected = false;
+      if (sendRetryTimer != NULL) { app_timer_cancel(sendRetryTimer);  sendRetryTimer = NULL; }
+      break;
+    }
+    case APP_MSG_APP_NOT_RUNNING: {
+      // PebbleKit JS went away. Its next ready message resumes sending.
+      APP_LOG(APP_LOG_LEVEL_WARNING, "PebbleKit JS not running. Pausing the send queue.");
+      pebkitReady = false;
+      if (sendRetryTimer != NULL) { app_timer_cancel(sendRetryTimer);  sendRetryTimer = NULL; }
+      break;
+    }
+    default: {
+      // Busy, timed out or rejected: worth another try shortly.
+      comm_startResendTimer();
+    }
+  }
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Callback for ConnectionService. Resumes a paused send queue when the
+/// phone comes back.
+/////////////////////////////////////////////////////////////////////////////
+static void comm_connectionHandler(bool connected) {
+  APP_LOG(APP_LOG_LEVEL_INFO, "Phone %s.", connected ? "connected" : "disconnected");
+  phoneConnected = connected;
+
+  if (!connected) {
+    // Retries would only fail; wait for the reconnect instead.
+    if (sendRetryTimer != NULL) { app_timer_cancel(sendRetryTimer);  sendRetryTimer = NULL; }
+    return;
+  }
+
+  // Time spent disconnected doesn't count against the queued messages.
+  sendRetryCount = 0;
+  if (sendRetryTimer != NULL) { app_timer_cancel(sendRetryTimer);  sendRetryTimer = NULL; }
+  comm_sendBufMsg();
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Reads an integer tuple of any width and signedness.
+/// @param[in]      tuple  Integer tuple
+/// @param[out]     value  The tuple's value
+/// @return  true if the tuple held an integer
+/////////////////////////////////////////////////////////////////////////////
+static bool comm_readTupleInt32(const Tuple* tuple, int32_t* value) {
+  bool isSigned = (tuple->type == TUPLE_INT);
+  if ( !isSigned && (tuple->type != TUPLE_UINT) ) return false;
+
+  switch (tuple->length) {
+    case 1: *value = isSigned ? tuple->value->int8  : (int32_t)tuple->value->uint8;  return true;
+    case 2: *value = isSigned ? tuple->value->int16 : (int32_t)tuple->value->uint16; return true;
+    case 4: *value = isSigned ? tuple->value->int32 : (int32_t)tuple->value->uint32; return true;
+    default: return false;
+  }
+}
+
+
+// Follow-up work an inbound tuple asks for. The handlers only flag it, so
+// that it runs once per inbound message however many tuples want it.
+#define INBOX_EFFECT_NONE  0
+#define INBOX_EFFECT_SAVE  (1 << 0)    ///< settings changed; write them to persistent storage
+#define INBOX_EFFECT_SEND  (1 << 1)    ///< the phone can take messages; pump the send queue
+
+// InboxHandler is a pointer to a function that takes a single parameter
+// (the inbound tuple, read in place) and returns INBOX_EFFECT_* flags.
+typedef uint8_t (*InboxHandler)(const Tuple*);
 
+
+/////////////////////////////////////////////////////////////////////////////
+/// PebbleKit JS is ready! Safe to send messages.
+/////////////////////////////////////////////////////////////////////////////
+static uint8_t comm_inboxPebkitReady(const Tuple* tuple) {
+  pebkitReady = true;
+  sendRetryCount = 0;
+  if (sendRetryTimer != NULL) { app_timer_cancel(sendRetryTimer);  sendRetryTimer = NULL; }
+  APP_LOG(APP_LOG_LEVEL_INFO, "PebbleKit JS sent ready message!");
+
+  // Saved settings were applied in comm_open; the phone will send any
+  // changes it has.
+  return INBOX_EFFECT_SEND;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Currency symbol setting. The string is passed to the Model straight from
+/// the inbox buffer; the Model keeps its own copy only if it changed.
+/////////////////////////////////////////////////////////////////////////////
+static uint8_t comm_inboxCurrencySymbol(const Tuple* tuple) {
   MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
-  Tuple *tuple = NULL;
+  if ( (tuple->type != TUPLE_CSTRING) || (tuple->length == 0) ) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Currency symbol is not a string.");
+    return INBOX_EFFECT_NONE;
+  }
 
-  if ( (tuple = dict_find(iterator, MESSAGE_KEY_PEBKIT_READY)) != NULL ) {
-    // PebbleKit JS is ready! Safe to send messages
-    pebkitReady = true;
-    APP_LOG(APP_LOG_LEVEL_INFO, "PebbleKit JS sent ready message!");
+  if ( (mpaRet = Model_setCurrencySymbol(dataModel, tuple->value->cstring)) != MPA_SUCCESS) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Error setting %s in data model: %s", "Currency symbol", MagPebApp_getErrMsg(mpaRet));
+    return INBOX_EFFECT_NONE;
+  }
+  return INBOX_EFFECT_SAVE;
+}
 
-    bool empty = true;
-    if ( (sendBuffer != NULL) && ( (mpaRet = RingBuffer_empty(sendBuffer, &empty)) != MPA_SUCCESS) ) {
-      APP_LOG(APP_LOG_LEVEL_ERROR, "Error checking sendBuffer: %s", MagPebApp_getErrMsg(mpaRet));
-        return;
-    }
-    if (!empty) { comm_sendBufMsg(); }
 
-    // Ready to load saved data from persistent memory now.
-    comm_loadPersistent();
+/////////////////////////////////////////////////////////////////////////////
+/// Default salary setting, in thousands per year.
+/////////////////////////////////////////////////////////////////////////////
+static uint8_t comm_inboxDefaultKiloSalary(const Tuple* tuple) {
+  MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
+  const char* readable = "Default Salary";
+  int32_t kiloSalary = 0;
+  if (!comm_readTupleInt32(tuple, &kiloSalary) || (kiloSalary < 0) ) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "%s is not a valid integer.", readable);
+    return INBOX_EFFECT_NONE;
   }
 
-  if ( (tuple = dict_find(iterator, MESSAGE_KEY_CURRENCY_SYMBOL)) != NULL ) {
-    const char* readable = "Currency symbol";
-    size_t bufsize = strlen(tuple->value->cstring)+1;
-    char* currencySymbolBuf = NULL;
-    currencySymbolBuf = malloc(bufsize);
-    if (!unloadTupleStr(&currencySymbolBuf, bufsize, tuple, readable)) {
-      APP_LOG(APP_LOG_LEVEL_ERROR, "Error in unloadTupleStr.");
-    } else {
-      APP_LOG(APP_LOG_LEVEL_DEBUG, "currencySymbolBuf = %s", currencySymbolBuf);
-      if ( (mpaRet = Model_setCurrencySymbol(dataModel, currencySymbolBuf)) != MPA_SUCCESS) {
-        APP_LOG(APP_LOG_LEVEL_ERROR, "Error setting %s in data model: %s", readable, MagPebApp_getErrMsg(mpaRet));
-      }
-    }
-    if (currencySymbolBuf != NULL) { free(currencySymbolBuf); currencySymbolBuf = NULL; }
-    comm_savePersistent();
+  uint32_t defaultMilliHourly = 0;
+  if ( (mpaRet = u32mult_u32_u32(&defaultMilliHourly, (uint32_t)kiloSalary, (1000*1000/2080))) != MPA_SUCCESS) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Error setting %s in data model: %s", readable, MagPebApp_getErrMsg(mpaRet));
+    return INBOX_EFFECT_NONE;
   }
+  if ( (mpaRet = Model_setDefaultMilliHourly(dataModel, defaultMilliHourly)) != MPA_SUCCESS) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Error setting %s in data model: %s", readable, MagPebApp_getErrMsg(mpaRet));
+    return INBOX_EFFECT_NONE;
+  }
+  return INBOX_EFFECT_SAVE;
+}
 
-  if ( (tuple = dict_find(iterator, MESSAGE_KEY_DEFAULT_KILO_SALARY)) != NULL ) {
-    const char* readable = "Default Salary";
-    uint32_t defaultMilliHourly = 0;
-    if (unloadTupleLong((long int*)&defaultMilliHourly, tuple, readable)) {
-      if ( (mpaRet = u32mult_u32_u32(&defaultMilliHourly, defaultMilliHourly, (1000*1000/2080))) != MPA_SUCCESS) {
-        APP_LOG(APP_LOG_LEVEL_ERROR, "Error setting %s in data model: %s", readable, MagPebApp_getErrMsg(mpaRet));
-      }
-      if ( (mpaRet = Model_setDefaultMilliHourly(dataModel, (uint32_t)defaultMilliHourly)) != MPA_SUCCESS) {
-        APP_LOG(APP_LOG_LEVEL_ERROR, "Error setting %s in data model: %s", readable, MagPebApp_getErrMsg(mpaRet));
-      }
-    }
-    comm_savePersistent();
+
+/////////////////////////////////////////////////////////////////////////////
+/// Budget alarm step setting, in whole currency units (0 turns alarms off).
+/////////////////////////////////////////////////////////////////////////////
+static uint8_t comm_inboxBudgetStep(const Tuple* tuple) {
+  int32_t step = 0;
+  if (!comm_readTupleInt32(tuple, &step) || (step < 0) ) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Budget step is not a valid integer.");
+    return INBOX_EFFECT_NONE;
   }
 
+  budgetStep = (uint32_t)step;
+  comm_scheduleBudgetAlarm();
+  return INBOX_EFFECT_SAVE;
+}
 
 
-  if (!commHandlers.updateViewData) {
-    APP_LOG(APP_LOG_LEVEL_ERROR, "Attempted operation on NULL pointer.");
-  } else {
-    (*commHandlers.updateViewData)(dataModel);
+// Inbound message keys and their handlers. (Message keys are assigned at
+// build time, so the table refers to them by address.)
+typedef struct InboxRoute {
+  const uint32_t*  key;
+  InboxHandler     handler;
+} InboxRoute;
+
+static const InboxRoute inboxRoutes[] = {
+  { &MESSAGE_KEY_PEBKIT_READY,         comm_inboxPebkitReady },
+  { &MESSAGE_KEY_CURRENCY_SYMBOL,      comm_inboxCurrencySymbol },
+  { &MESSAGE_KEY_DEFAULT_KILO_SALARY,  comm_inboxDefaultKiloSalary },
+  { &MESSAGE_KEY_BUDGET_STEP,          comm_inboxBudgetStep },
+};
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Handles callbacks from the JS component. Each tuple is read once, in
+/// place, and dispatched through inboxRoutes. The work the handlers flag is
+/// done once, after the last tuple.
+/////////////////////////////////////////////////////////////////////////////
+static void inbox_received_callback(DictionaryIterator *iterator, void *context) {
+  APP_LOG(APP_LOG_LEVEL_INFO, "Inbox receive successful.");
+
+  if (dataModel == NULL) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Data model is not yet initialized.");
+    return;
+  }
+
+  uint8_t effects = INBOX_EFFECT_NONE;
+  for (Tuple* tuple = dict_read_first(iterator); tuple != NULL; tuple = dict_read_next(iterator)) {
+    size_t idx = 0;
+    while ( (idx < ARRAY_LENGTH(inboxRoutes)) && (*inboxRoutes[idx].key != tuple->key) ) idx++;
+
+    if (idx == ARRAY_LENGTH(inboxRoutes)) {
+      APP_LOG(APP_LOG_LEVEL_WARNING, "Ignoring unknown message key %lu.", tuple->key);
+      continue;
+    }
+    effects |= (*inboxRoutes[idx].handler)(tuple);
   }
 
+  if (effects & INBOX_EFFECT_SAVE) comm_savePersistent();
+  if (effects & INBOX_EFFECT_SEND) comm_sendBufMsg();
+
+  comm_publishChanges();
 }
 
 
@@ -158,7 +445,9 @@ static void inbox_dropped_callback(AppMessageResult reason, void *context) {
 /////////////////////////////////////////////////////////////////////////////
 static void outbox_failed_callback(DictionaryIterator *iterator, AppMessageResult reason, void *context) {
   APP_LOG(APP_LOG_LEVEL_ERROR, "Outbox send failed! Reason: %d", (int)reason);
-  comm_startResendTimer();
+  // The failed batch is still at the head of the queue.
+  inFlightCount = 0;
+  comm_handleSendFailure(reason);
 }
 
 
@@ -166,6 +455,16 @@ static void outbox_failed_callback(DictionaryIterator *iterator, AppMessageResul
 /////////////////////////////////////////////////////////////////////////////
 static void outbox_sent_callback(DictionaryIterator *iterator, void *context) {
   APP_LOG(APP_LOG_LEVEL_INFO, "Outbox send successful.");
+
+  // Release the acknowledged batch...
+  for ( ; inFlightCount > 0; inFlightCount--) {
+    if (SlotQueue_drop(sendBuffer) != MPA_SUCCESS) break;
+  }
+  inFlightCount = 0;
+  sendRetryCount = 0;
+
+  // ...and pump the next one right away.
+  comm_sendBufMsg();
 }
 
 
@@ -178,116 +477,188 @@ bool comm_pebkitReady() {
 
 
 /////////////////////////////////////////////////////////////////////////////
-/// Queue data and send to PebbleKit.
+/// Queue data and send to PebbleKit. The message is copied into the queue,
+/// so the caller keeps ownership of its payload. If a message with the same
+/// key is already waiting in the queue (and not yet handed to the outbox),
+/// the new payload replaces the old one in place, since only the latest
+/// value of a key matters to the phone.
+/// @param[in]      msg  Message to send
+/// @param[in]      policy  What to do if the queue is full
+/// @return  true if the message was queued
+///          false if it was rejected
 /////////////////////////////////////////////////////////////////////////////
-void comm_enqMsg(Message* msg) {
+bool comm_enqMsg(const Message* msg, const SlotQueue_FullPolicy policy) {
   MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
   if (msg == NULL) {
     APP_LOG(APP_LOG_LEVEL_ERROR, "Tried to buffer a null message.");
-    return;
+    return false;
   }
 
   if (sendBuffer == NULL) {
     APP_LOG(APP_LOG_LEVEL_ERROR, "Send buffer is null.");
-    return;
+    return false;
+  }
+
+  // Validate the message before it can displace anything.
+  MsgSlot newSlot;
+  if ( (mpaRet = comm_fillSlot(&newSlot, msg)) != MPA_SUCCESS) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Cannot buffer message %d: %s", (int)msg->key, MagPebApp_getErrMsg(mpaRet));
+    return false;
   }
 
-  if ( (mpaRet = RingBuffer_write(sendBuffer, (void*)msg)) != MPA_SUCCESS) {
+  // Coalesce with a queued message of the same key (last writer wins)
+  size_t count = 0;
+  SlotQueue_count(sendBuffer, &count);
+  for (size_t idx=inFlightCount; idx<count; idx++) {
+    void* data = NULL;
+    if (SlotQueue_peekAt(sendBuffer, idx, &data) != MPA_SUCCESS) break;
+    MsgSlot* queued = (MsgSlot*) data;
+    if (queued->key == msg->key) {
+      APP_LOG(APP_LOG_LEVEL_DEBUG, "Coalescing queued message %d.", (int)msg->key);
+      *queued = newSlot;
+      comm_sendBufMsg();
+      return true;
+    }
+  }
+
+  void* data = NULL;
+  bool dropped = false;
+  if ( (mpaRet = SlotQueue_write(sendBuffer, policy, &data, &dropped)) != MPA_SUCCESS) {
     APP_LOG(APP_LOG_LEVEL_ERROR, "Error buffering message: %s", MagPebApp_getErrMsg(mpaRet));
-    comm_msg_destroy(msg);
-    return;
+    return false;
+  }
+  if (dropped) {
+    APP_LOG(APP_LOG_LEVEL_WARNING, "Send buffer full. Dropped the oldest message.");
+    // A dropped in-flight message is already in the outbox; its ack must
+    // not release one of the messages behind it.
+    if (inFlightCount > 0) inFlightCount--;
   }
+  *((MsgSlot*) data) = newSlot;
 
   comm_sendBufMsg();
+  return true;
 }
 
 
 /////////////////////////////////////////////////////////////////////////////
-/// Send buffered data to PebbleKit.
+/// Send buffered data to PebbleKit. As many queued messages as fit are
+/// packed into one outbox dictionary, so a backlog costs one Bluetooth round
+/// trip instead of one per message. The batch stays queued until
+/// outbox_sent_callback acknowledges it, which then pumps the next batch.
 /////////////////////////////////////////////////////////////////////////////
 void comm_sendBufMsg() {
   MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
 
+  // A batch is already on its way; its ack will send the next one.
+  if (inFlightCount > 0) return;
+
+  // A retry is already scheduled; let it run.
+  if (sendRetryTimer != NULL) return;
+
   void* data = NULL;
-  if ( (mpaRet = RingBuffer_peek(sendBuffer, &data)) != MPA_SUCCESS) {
-    APP_LOG(APP_LOG_LEVEL_ERROR, "Error reading buffered message: %s", MagPebApp_getErrMsg(mpaRet));
+  if ( (mpaRet = SlotQueue_peekAt(sendBuffer, 0, &data)) != MPA_SUCCESS) {
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "No buffered message to send: %s", MagPebApp_getErrMsg(mpaRet));
     return;
   }
 
-  Message* msg = (Message*) data;
-  if (msg == NULL) {
-    APP_LOG(APP_LOG_LEVEL_ERROR, "Send buffer contained a null message.");
-    return;
-  }
+  MsgSlot* msg = (MsgSlot*) data;
 
   // At this point, we know there is a non-null message in the send buffer.
 
-  // Check if PebbleKit JS is ready to receive...
-  if (!comm_pebkitReady()) {
+  // Check if PebbleKit JS is ready to receive... Its ready message and the
+  // connection service resume sending, so there's nothing to retry yet.
+  if (!comm_pebkitReady() || !phoneConnected) {
     APP_LOG(APP_LOG_LEVEL_WARNING, "Buffering message to phone until PebbleKit JS is ready...");
-    comm_startResendTimer();
     return;
   }
 
-  // Prepare the outbox buffer for this message
+  // Prepare the outbox buffer for this batch
   DictionaryIterator *outIter;
   AppMessageResult result = app_message_outbox_begin(&outIter);
   if (result != APP_MSG_OK) {
     // The outbox cannot be used right now
     APP_LOG(APP_LOG_LEVEL_WARNING, "Error preparing the outbox for message %d.  Result: %d", (int)msg->key, (int)result);
-    comm_startResendTimer();
+    comm_handleSendFailure(result);
     return;
   }
 
-  // Ready to write to app message outbox...
-  dict_write_cstring(outIter, msg->key, msg->payload);
+  // Ready to write to app message outbox... pack messages until one doesn't fit.
+  size_t count = 0;
+  SlotQueue_count(sendBuffer, &count);
+  uint8_t batchCount = 0;
+  for (size_t idx=0; idx<count; idx++) {
+    if (SlotQueue_peekAt(sendBuffer, idx, &data) != MPA_SUCCESS) break;
+    msg = (MsgSlot*) data;
+    if (comm_writeSlot(outIter, msg) != DICT_OK) break;
+    batchCount++;
+  }
+
+  if (batchCount == 0) {
+    // Even a lone message doesn't fit in the outbox; it never will.
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Message %d is too large for the outbox. Abandoning it.", (int)msg->key);
+    SlotQueue_drop(sendBuffer);
+    comm_sendBufMsg();
+    return;
+  }
 
-  // Send this message
+  // Send this batch
   result = app_message_outbox_send();
 
   if(result != APP_MSG_OK) {
-    APP_LOG(APP_LOG_LEVEL_WARNING, "Error sending the outbox for message %d.  Result: %d", (int)msg->key, (int)result);
-    comm_startResendTimer();
+    APP_LOG(APP_LOG_LEVEL_WARNING, "Error sending the outbox for %d messages.  Result: %d", (int)batchCount, (int)result);
+    comm_handleSendFailure(result);
     return;
   }
 
-  // Successful send attempt!
-  APP_LOG(APP_LOG_LEVEL_INFO, "Sent outbox message %d!", (int)msg->key);
-  sendRetryCount = 0;
-  RingBuffer_drop(sendBuffer);
-  comm_msg_destroy(msg);
+  // Successful send attempt! Wait for the ack.
+  APP_LOG(APP_LOG_LEVEL_INFO, "Sent %d outbox messages!", (int)batchCount);
+  inFlightCount = batchCount;
   if (sendRetryTimer != NULL) { app_timer_cancel(sendRetryTimer);  sendRetryTimer = NULL; }
 }
 
 
+/////////////////////////////////////////////////////////////////////////////
+/// Callback for the resend timer.
+/////////////////////////////////////////////////////////////////////////////
+static void comm_resendTimerCallback(void* data) {
+  sendRetryTimer = NULL;
+  comm_sendBufMsg();
+}
+
+
 /////////////////////////////////////////////////////////////////////////////
 /// Starts a backoff timer to retry the first message in the send buffer.
+/// The delay doubles with each consecutive failure, up to a cap, and is
+/// randomized over its upper half so that retries don't fall into lockstep
+/// with whatever keeps the outbox busy.
 /////////////////////////////////////////////////////////////////////////////
 void comm_startResendTimer() {
   MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
 
   void* data = NULL;
-  if ( (mpaRet = RingBuffer_peek(sendBuffer, &data)) != MPA_SUCCESS) {
+  if ( (mpaRet = SlotQueue_peekAt(sendBuffer, 0, &data)) != MPA_SUCCESS) {
     APP_LOG(APP_LOG_LEVEL_ERROR, "Error reading buffered message: %s", MagPebApp_getErrMsg(mpaRet));
     return;
   }
 
-  Message* msg = (Message*) data;
-  if (msg == NULL) {
-    APP_LOG(APP_LOG_LEVEL_ERROR, "Send buffer contained a null message.");
-    return;
-  }
+  MsgSlot* msg = (MsgSlot*) data;
+
+  if (sendRetryTimer != NULL) { app_timer_cancel(sendRetryTimer);  sendRetryTimer = NULL; }
 
   if (sendRetryCount < MAX_SEND_RETRIES) {
+    uint32_t backoffMs = (uint32_t)SEND_RETRY_BASE_MS << sendRetryCount;
+    if (backoffMs > SEND_RETRY_MAX_MS) backoffMs = SEND_RETRY_MAX_MS;
+    uint32_t retryIntervalMs = backoffMs/2 + (uint32_t)rand() % (backoffMs/2 + 1);
     sendRetryCount++;
-    uint16_t retryIntervalMs = (sendRetryCount * 1000);
-    APP_LOG(APP_LOG_LEVEL_INFO, "Retrying message (%d) send in %d ms...", (int)msg->key, retryIntervalMs);
-    sendRetryTimer = app_timer_register(retryIntervalMs, comm_sendBufMsg, NULL);
+    APP_LOG(APP_LOG_LEVEL_INFO, "Retrying message (%d) send in %lu ms...", (int)msg->key, retryIntervalMs);
+    sendRetryTimer = app_timer_register(retryIntervalMs, comm_resendTimerCallback, NULL);
   } else {
     APP_LOG(APP_LOG_LEVEL_ERROR, "Max retries failed. Abandoning message (%d).", (int)msg->key);
     sendRetryCount = 0;
-    RingBuffer_drop(sendBuffer);
-    if (sendRetryTimer != NULL) { app_timer_cancel(sendRetryTimer);  sendRetryTimer = NULL; }
+    SlotQueue_drop(sendBuffer);
+
+    // Give the rest of the queue its own chance.
+    comm_sendBufMsg();
   }
 }
 
@@ -312,7 +683,7 @@ void comm_sendMsg(const Message* msg) {
   // Prepare the outbox buffer for this message
   AppMessageResult result = app_message_outbox_begin(&outIter);
   if (result == APP_MSG_OK) {
-    dict_write_cstring(outIter, msg->key, msg->payload);
+    comm_writeMsg(outIter, msg);
 
     // Send this message
     result = app_message_outbox_send();
@@ -331,53 +702,198 @@ void comm_sendMsg(const Message* msg) {
 
 
 /////////////////////////////////////////////////////////////////////////////
-/// Saves app settings to persistent storage.
+/// Writes the Model's settings to persistent storage, unless they match
+/// what is already stored.
 /////////////////////////////////////////////////////////////////////////////
-void comm_savePersistent() {
+static void comm_flushPersistent() {
+  if (settingsWriteTimer != NULL) { app_timer_cancel(settingsWriteTimer);  settingsWriteTimer = NULL; }
+
   if (dataModel == NULL) {
     APP_LOG(APP_LOG_LEVEL_ERROR, "Data model is not yet initialized.");
     return;
   }
 
   MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
+  ClaySettings current;
+  memset(&current, 0, sizeof(current));
+  current.settingsVer = SETTINGS_VER;
 
-	if ( (mpaRet = Model_getDefaultMilliHourly(dataModel, &(settings.defaultMilliHourly))) != MPA_SUCCESS) {
-		APP_LOG(APP_LOG_LEVEL_ERROR, "Could not retrieve custom setting: %s", MagPebApp_getErrMsg(mpaRet));
-		return;
-	}
-  persist_write_data(SETTINGS_STRUCT_KEY, &settings, sizeof(settings));
-
-  // Write all string settings
-  for (int keyIdx=0; keyIdx<LAST_STR_SETTING; keyIdx++) {
-    // Fetch data stored elsewhere
-    switch(keyIdx) {
-      case CURRENCY_SYMBOL_SETTING: {
-        if (strSettings[keyIdx] != NULL) { free(strSettings[keyIdx]); strSettings[keyIdx] = NULL; }
-				char* tempPtr = NULL;
-        if ( (mpaRet = Model_getCurrencySymbol(dataModel, &tempPtr)) != MPA_SUCCESS) {
-          APP_LOG(APP_LOG_LEVEL_ERROR, "Could not retrieve custom string: %s", MagPebApp_getErrMsg(mpaRet));
-          return;
-        }
-        if ( (mpaRet = strxcpyalloc(&strSettings[keyIdx], tempPtr)) != MPA_SUCCESS) {
-          APP_LOG(APP_LOG_LEVEL_ERROR, "Error in strxcpyalloc: %s", MagPebApp_getErrMsg(mpaRet));
-          return;
-        }
-        break;
-      }
-    } // end switch(keyIdx)
+  uint32_t defaultMilliHourly = 0;
+  if ( (mpaRet = Model_getDefaultMilliHourly(dataModel, &defaultMilliHourly)) != MPA_SUCCESS) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Could not retrieve custom setting: %s", MagPebApp_getErrMsg(mpaRet));
+    return;
+  }
+  current.defaultMilliHourly = defaultMilliHourly;
+  current.budgetStep = budgetStep;
+  char* currSym = NULL;
+  if ( (mpaRet = Model_getCurrencySymbol(dataModel, &currSym)) != MPA_SUCCESS) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Could not retrieve custom string: %s", MagPebApp_getErrMsg(mpaRet));
+    return;
+  }
+  if ( (currSym != NULL) && !strxcpy(current.currencySymbol, sizeof(current.currencySymbol), currSym, "Currency symbol") ) {
+    return;
+  }
 
+  // Flash writes are slow and wear the flash; skip the ones that change nothing.
+  if (memcmp(&current, &settings, sizeof(current)) == 0) {
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "Settings unchanged. Skipping write.");
+    return;
+  }
 
-    // Write data to persistent memory on watch
-    status_t result = 0;
-    if ( (result = persist_write_string(keyIdx, strSettings[keyIdx])) < 0) {
-      APP_LOG(APP_LOG_LEVEL_ERROR, "Could not write string #%d to persistent storage. Error: %ld", keyIdx, result);
-    } else {
-      APP_LOG(APP_LOG_LEVEL_DEBUG, "Wrote string #%d (%s) to persistent storage.", keyIdx, strSettings[keyIdx]);
-    }
+  status_t result = 0;
+  if ( (result = persist_write_data(SETTINGS_STRUCT_KEY, &current, sizeof(current))) < 0) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Could not write settings to persistent storage. Error: %ld", result);
+    return;
+  }
+  settings = current;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Callback for the settings write-behind timer.
+/////////////////////////////////////////////////////////////////////////////
+static void comm_settingsWriteTimerCallback(void* data) {
+  settingsWriteTimer = NULL;
+  comm_flushPersistent();
+}
+
+
+#if PBL_API_EXISTS(app_glance_reload)
+/////////////////////////////////////////////////////////////////////////////
+/// Formats an amount in thousandths of currency units as currency.
+/////////////////////////////////////////////////////////////////////////////
+static bool comm_fmtMilliCost(char* buf, const size_t bufsize, const char* currSym, const uint64_t milliCost) {
+  // JRB NOTE: Pebble's printf doesn't do 64-bit integers.
+  uint64_t wholeUnits = milliCost / 1000;
+  if (wholeUnits > MPA_MAX(uint32_t)) return false;
+
+  long lret = snprintf(buf, bufsize, "%s%lu.%02lu", (currSym != NULL) ? currSym : "", (unsigned long)wholeUnits, (unsigned long)(milliCost % 1000) / 10);
+  return (lret >= 0) && ((size_t)lret < bufsize);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Fills in the app glance, with the subtitle passed as the context (or no
+/// slice at all, if it is NULL).
+/////////////////////////////////////////////////////////////////////////////
+static void comm_glanceReloadCallback(AppGlanceReloadSession* session, size_t limit, void* context) {
+  if ( (limit < 1) || (context == NULL) ) return;
+
+  AppGlanceResult result = app_glance_add_slice(session, (AppGlanceSlice) {
+    .layout = {
+      .icon = APP_GLANCE_SLICE_DEFAULT_ICON,
+      .subtitle_template_string = (const char*) context
+    },
+    .expiration_time = APP_GLANCE_SLICE_NO_EXPIRATION
+  });
+  if (result != APP_GLANCE_RESULT_SUCCESS) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Could not add app glance slice: %d", (int)result);
+  }
+}
+#endif
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Shows the meeting in the launcher's app glance, so the cost can be
+/// checked without launching the app. For a running meeting, the subtitle
+/// is a template that the launcher keeps counting up from the checkpoint
+/// timestamp, eg. "$25.00 + $300.00/h for 0:12:34 (6)". Without a meeting,
+/// the glance is cleared.
+/////////////////////////////////////////////////////////////////////////////
+void comm_publishGlance() {
+#if PBL_API_EXISTS(app_glance_reload)
+  if (dataModel == NULL) return;
+
+  MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
+  Model_Checkpoint checkpoint;
+  char* currSym = NULL;
+  if ( ((mpaRet = Model_getCheckpoint(dataModel, &checkpoint)) != MPA_SUCCESS) ||
+       ((mpaRet = Model_getCurrencySymbol(dataModel, &currSym)) != MPA_SUCCESS) ) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Could not read meeting for app glance: %s", MagPebApp_getErrMsg(mpaRet));
+    return;
+  }
+
+  if ( (checkpoint.status == MODEL_STATE_NO_ATTENDEES) && (checkpoint.lastRateMilliCost == 0) ) {
+    app_glance_reload(comm_glanceReloadCallback, NULL);
+    return;
+  }
+
+  char costBuf[FMTD_COST_SZ];
+  char rateBuf[FMTD_COST_SZ];
+  char subtitle[96];
+  if (!comm_fmtMilliCost(costBuf, sizeof(costBuf), currSym, checkpoint.lastRateMilliCost) ||
+      !comm_fmtMilliCost(rateBuf, sizeof(rateBuf), currSym, checkpoint.totalMilliHourly) ) {
+    return;
+  }
+
+  long lret = 0;
+  if (checkpoint.status == MODEL_STATE_STARTED) {
+    lret = snprintf(subtitle, sizeof(subtitle), "%s + %s/h for {time_since(%lu)|format('%%T')} (%u)",
+                    costBuf, rateBuf, (unsigned long)checkpoint.lastRateChangeTS, checkpoint.numAttendees);
+  } else {
+    lret = snprintf(subtitle, sizeof(subtitle), "%s, paused (%u)", costBuf, checkpoint.numAttendees);
+  }
+  if ( (lret < 0) || ((size_t)lret >= sizeof(subtitle)) ) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "App glance subtitle does not fit.");
+    return;
+  }
+
+  // The reload calls back synchronously, so the subtitle can live on the stack.
+  app_glance_reload(comm_glanceReloadCallback, subtitle);
+#endif
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Saves app settings to persistent storage. The write happens a little
+/// later, so that a burst of changes costs one write; comm_close flushes any
+/// write still pending.
+/////////////////////////////////////////////////////////////////////////////
+void comm_savePersistent() {
+  if (settingsWriteTimer != NULL) {
+    app_timer_reschedule(settingsWriteTimer, SETTINGS_WRITE_DELAY_MS);
+  } else {
+    settingsWriteTimer = app_timer_register(SETTINGS_WRITE_DELAY_MS, comm_settingsWriteTimerCallback, NULL);
+  }
+}
 
-  } // end for
-  return;
 
+/////////////////////////////////////////////////////////////////////////////
+/// Converts settings stored by an older version of the app to the current
+/// layout, and removes the keys the current layout no longer uses.
+/// @param[in]      stored  Bytes read from SETTINGS_STRUCT_KEY
+/// @param[in]      storedSize  Number of bytes read
+/// @param[out]     migrated  Settings in the current layout
+/// @return  MPA_SUCCESS on success
+///          MPA_INVALID_INPUT_ERR if the stored layout is not recognized
+/////////////////////////////////////////////////////////////////////////////
+static MagPebApp_ErrCode comm_migrateSettings(const uint8_t* stored, const int storedSize, ClaySettings* migrated) {
+  memset(migrated, 0, sizeof(*migrated));
+  migrated->settingsVer = SETTINGS_VER;
+
+  switch (stored[0]) {
+    case 0:
+    case 1: {
+      if (storedSize != sizeof(LegacySettings)) return MPA_INVALID_INPUT_ERR;
+      LegacySettings legacy;
+      memcpy(&legacy, stored, sizeof(legacy));
+      migrated->defaultMilliHourly = legacy.defaultMilliHourly;
+
+      if (persist_exists(LEGACY_CURRENCY_SYMBOL_KEY)) {
+        persist_read_string(LEGACY_CURRENCY_SYMBOL_KEY, migrated->currencySymbol, sizeof(migrated->currencySymbol));
+        persist_delete(LEGACY_CURRENCY_SYMBOL_KEY);
+      }
+      return MPA_SUCCESS;
+    }
+    case 2: {
+      // Version 2 is version 3 without the budget step.
+      if (storedSize != offsetof(ClaySettings, budgetStep)) return MPA_INVALID_INPUT_ERR;
+      memcpy(migrated, stored, storedSize);
+      migrated->settingsVer = SETTINGS_VER;
+      return MPA_SUCCESS;
+    }
+    default: return MPA_INVALID_INPUT_ERR;
+  }
 }
 
 
@@ -392,52 +908,87 @@ void comm_loadPersistent() {
 
   MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
 
-  if (persist_exists(SETTINGS_STRUCT_KEY)) {
-    persist_read_data(SETTINGS_STRUCT_KEY, &settings, sizeof(settings));
+  // Read whatever layout is stored; its first byte is always the version.
+  uint8_t stored[sizeof(ClaySettings)];
+  int storedSize = persist_read_data(SETTINGS_STRUCT_KEY, stored, sizeof(stored));
+  if (storedSize <= 0) {
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "No saved settings.");
+    return;
   }
 
-  if (settings.defaultMilliHourly <= 0) {
+  ClaySettings loaded;
+  if ( (stored[0] == SETTINGS_VER) && (storedSize == sizeof(loaded)) ) {
+    memcpy(&loaded, stored, sizeof(loaded));
+    settings = loaded;
+  } else if ( (mpaRet = comm_migrateSettings(stored, storedSize, &loaded)) == MPA_SUCCESS) {
+    APP_LOG(APP_LOG_LEVEL_INFO, "Migrated settings from version %d.", (int)stored[0]);
+    // Store the new layout, even though the Model is unchanged.
+    comm_savePersistent();
+  } else {
+    APP_LOG(APP_LOG_LEVEL_WARNING, "Unrecognized settings version %d. Ignoring them.", (int)stored[0]);
+    return;
+  }
+  loaded.currencySymbol[sizeof(loaded.currencySymbol)-1] = '\0';
+  budgetStep = loaded.budgetStep;
+
+  if (loaded.defaultMilliHourly <= 0) {
     APP_LOG(APP_LOG_LEVEL_WARNING, "Tried to set a default salary of zero.");
   } else {
-  	if ( (mpaRet = Model_setDefaultMilliHourly(dataModel, settings.defaultMilliHourly)) != MPA_SUCCESS) {
-  		APP_LOG(APP_LOG_LEVEL_ERROR, "Error setting %s in data model: %s", "default salary", MagPebApp_getErrMsg(mpaRet));
-  	}
-  }
-
-  // Read all string settings
-  int keyIdx;
-  for (keyIdx=0; keyIdx<LAST_STR_SETTING; keyIdx++) {
-    if (persist_exists(keyIdx)) {
-      if (strSettings[keyIdx] != NULL) { free(strSettings[keyIdx]); strSettings[keyIdx] = NULL; }
-      int size = persist_get_size(keyIdx);
-      if ( (strSettings[keyIdx] = calloc(size, sizeof(*strSettings[keyIdx])) ) == NULL) { goto freemem; }
-
-      // Read the string from persistent watch storage.
-      status_t result;
-      if ( (result = persist_read_string(keyIdx, strSettings[keyIdx], size)) < 0) {
-        APP_LOG(APP_LOG_LEVEL_ERROR, "Could not read string #%d from persistent storage. Error: %ld", keyIdx, result);
-      } else {
-        APP_LOG(APP_LOG_LEVEL_DEBUG, "Read string #%d (%s) from persistent storage.", keyIdx, strSettings[keyIdx]);
-      }
+    if ( (mpaRet = Model_setDefaultMilliHourly(dataModel, loaded.defaultMilliHourly)) != MPA_SUCCESS) {
+      APP_LOG(APP_LOG_LEVEL_ERROR, "Error setting %s in data model: %s", "default salary", MagPebApp_getErrMsg(mpaRet));
+    }
+  }
+
+  // Settings migrated without a stored symbol keep the locale's default.
+  if (loaded.currencySymbol[0] != '\0') {
+    if ( (mpaRet = Model_setCurrencySymbol(dataModel, loaded.currencySymbol)) != MPA_SUCCESS) {
+      APP_LOG(APP_LOG_LEVEL_ERROR, "Error setting %s in data model: %s", "Currency symbol", MagPebApp_getErrMsg(mpaRet));
+    }
+  }
+}
+
 
-      switch(keyIdx) {
-        case CURRENCY_SYMBOL_SETTING: {
-          if ( (mpaRet = Model_setCurrencySymbol(dataModel, strSettings[keyIdx])) != MPA_SUCCESS) {
-            APP_LOG(APP_LOG_LEVEL_ERROR, "Error setting %s in data model: %s", "Currency symbol", MagPebApp_getErrMsg(mpaRet));
-          } else {
-            // update any UI dependent on custom string
-          }
-          break;
-        }
-      } // end switch(keyIdx)
-    } // end if persist_exists(keyIdx)
-  } // end for
+/////////////////////////////////////////////////////////////////////////////
+/// Persists the meeting's checkpoint, so that the meeting survives the app
+/// closing. Called on meeting state transitions only; the running cost is
+/// never written.
+/////////////////////////////////////////////////////////////////////////////
+static void comm_saveCheckpoint() {
+  MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
+  Model_Checkpoint checkpoint;
+  if ( (mpaRet = Model_getCheckpoint(dataModel, &checkpoint)) != MPA_SUCCESS) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Could not get meeting checkpoint: %s", MagPebApp_getErrMsg(mpaRet));
+    return;
+  }
+
+  status_t result = 0;
+  if ( (result = persist_write_data(CHECKPOINT_KEY, &checkpoint, sizeof(checkpoint))) < 0) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Could not write meeting checkpoint. Error: %ld", result);
+  }
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Resumes the meeting from its persisted checkpoint, if there is one.
+/////////////////////////////////////////////////////////////////////////////
+static void comm_loadCheckpoint() {
+  if (dataModel == NULL) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Data model is not yet initialized.");
+    return;
+  }
 
-  return;
+  MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
+  Model_Checkpoint checkpoint;
+  memset(&checkpoint, 0, sizeof(checkpoint));
+  int storedSize = persist_read_data(CHECKPOINT_KEY, &checkpoint, sizeof(checkpoint));
+  if ( (storedSize != (int)sizeof(checkpoint)) && (storedSize != MODEL_CHECKPOINT_V1_SZ) ) {
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "No meeting checkpoint.");
+    return;
+  }
 
-freemem:
-  APP_LOG(APP_LOG_LEVEL_ERROR, "Error... freeing memory");
-  if (strSettings[keyIdx] != NULL) { free(strSettings[keyIdx]); strSettings[keyIdx] = NULL; }
+  if ( (mpaRet = Model_restoreCheckpoint(dataModel, &checkpoint)) != MPA_SUCCESS) {
+    APP_LOG(APP_LOG_LEVEL_WARNING, "Could not restore meeting checkpoint: %s", MagPebApp_getErrMsg(mpaRet));
+  }
 }
 
 
@@ -445,17 +996,9 @@ freemem:
 /// Callback for TickTimerService
 /////////////////////////////////////////////////////////////////////////////
 void comm_tickHandler(struct tm *tick_time, TimeUnits units_changed) {
-  { // limiting timebuf in a local scope
-    const size_t bufsize = 40;
-    char timebuf[bufsize];
-    size_t ret = 0;
-
-    if ( (ret = strftime(timebuf, (int)bufsize, "%a, %d %b %Y %T %z", tick_time)) == 0) {
-      APP_LOG(APP_LOG_LEVEL_ERROR, "Error returned: %d", ret);
-      return;
-    }
-    // HEAP_LOG(timebuf);
-  }
+#if defined(MPA_DEBUG_ALLOC)
+  uint32_t allocCountAtTick = MagPebApp_getAllocCount();
+#endif
 
   MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
   if ( (mpaRet = Model_updateTime(dataModel, tick_time, units_changed)) != MPA_SUCCESS) {
@@ -467,12 +1010,172 @@ void comm_tickHandler(struct tm *tick_time, TimeUnits units_changed) {
   }
   (*commHandlers.updateViewTime)(tick_time);
 
-  if (!commHandlers.updateViewData) {
-    APP_LOG(APP_LOG_LEVEL_ERROR, "Attempted operation on NULL pointer.");
-  } else {
-    (*commHandlers.updateViewData)(dataModel);
+  comm_publishChanges();
+
+  comm_scheduleUpdate();
+
+#if defined(MPA_DEBUG_ALLOC)
+  // The steady-state tick should never touch the heap.
+  uint32_t tickAllocs = MagPebApp_getAllocCount() - allocCountAtTick;
+  if (tickAllocs > 0) {
+    APP_LOG(APP_LOG_LEVEL_WARNING, "%lu heap allocations during tick.", tickAllocs);
   }
+#endif
+}
 
+
+/////////////////////////////////////////////////////////////////////////////
+/// Callback for the update timer armed by comm_scheduleUpdate.
+/////////////////////////////////////////////////////////////////////////////
+static void comm_updateTimerCallback(void* data) {
+  updateTimer = NULL;
+
+  time_t now = 0;
+  if (dataModel == NULL || Model_getTime(dataModel, &now, NULL) != MPA_SUCCESS) now = time(NULL);
+  struct tm* tick_time = localtime(&now);
+  TimeUnits units_changed = (tick_time->tm_sec == 0) ? (SECOND_UNIT | MINUTE_UNIT) : SECOND_UNIT;
+  comm_tickHandler(tick_time, units_changed);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Callback for AppFocusService, as focus is about to change. Losing focus
+/// (eg. to a notification) suspends all view updates at once, before the
+/// covering window animates in.
+/////////////////////////////////////////////////////////////////////////////
+static void comm_focusWillChange(bool inFocus) {
+  if (inFocus || !appInFocus) return;
+
+  appInFocus = false;
+  PublishGate_setOpen(focusGate, false);
+  if (updateTimer != NULL) { app_timer_cancel(updateTimer);  updateTimer = NULL; }
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Callback for AppFocusService, once focus has changed. Regaining focus
+/// catches the view up with a single exact recalculation, which also
+/// publishes the changes held back meanwhile, and resumes the updates.
+/////////////////////////////////////////////////////////////////////////////
+static void comm_focusDidChange(bool inFocus) {
+  if (!inFocus || appInFocus) return;
+
+  appInFocus = true;
+  PublishGate_setOpen(focusGate, true);
+  comm_updateTimerCallback(NULL);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Returns how many view updates were held back since comm_open because the
+/// app was out of focus, for battery reporting.
+/////////////////////////////////////////////////////////////////////////////
+uint32_t comm_getSkippedRedraws() {
+  uint32_t skippedRedraws = 0;
+  PublishGate_getHeldBack(focusGate, &skippedRedraws);
+  return skippedRedraws;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Arms a single timer for the next moment anything visible changes: either
+/// the displayed meeting cost or the minute shown by the clock, whichever
+/// comes first. This replaces a fixed per-second tick, which mostly woke up
+/// the watch to redraw identical text.
+/////////////////////////////////////////////////////////////////////////////
+void comm_scheduleUpdate() {
+  MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
+
+  if (updateTimer != NULL) { app_timer_cancel(updateTimer);  updateTimer = NULL; }
+
+  // Nothing is visible while out of focus; comm_focusDidChange catches up.
+  if (!appInFocus) return;
+
+  time_t nowSecs = 0;
+  uint16_t nowMs = 0;
+  if ( (dataModel == NULL) || (Model_getTime(dataModel, &nowSecs, &nowMs) != MPA_SUCCESS) ) {
+    time_ms(&nowSecs, &nowMs);
+  }
+
+  // The clock only shows minutes.
+  time_t nextUpdateTS = nowSecs - (nowSecs % 60) + 60;
+
+  time_t costChangeTS = 0;
+  if ( (dataModel != NULL) && (mpaRet = Model_getNextVisibleChange(dataModel, &costChangeTS)) != MPA_SUCCESS) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Error computing next cost change: %s", MagPebApp_getErrMsg(mpaRet));
+    costChangeTS = nowSecs + 1;
+  }
+  if ( (costChangeTS != 0) && (costChangeTS < nextUpdateTS) ) nextUpdateTS = costChangeTS;
+  if (nextUpdateTS <= nowSecs) nextUpdateTS = nowSecs + 1;
+
+  uint32_t delayMs = (uint32_t)(nextUpdateTS - nowSecs) * 1000 - nowMs + UPDATE_TIMER_SLACK_MS;
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "Next view update in %lu ms", delayMs);
+  updateTimer = app_timer_register(delayMs, comm_updateTimerCallback, NULL);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Callback for the budget alarm timer.
+/////////////////////////////////////////////////////////////////////////////
+static void comm_budgetTimerCallback(void* data) {
+  budgetTimer = NULL;
+
+  // Bring the cost up to now, so the next alarm is for the next step.
+  uint64_t centiCost = 0;
+  Model_updateTime(dataModel, NULL, SECOND_UNIT);
+  if ( (Model_getCentiMeetingCost(dataModel, &centiCost) == MPA_SUCCESS) && (centiCost * 10 >= budgetNextMilliCost) ) {
+    APP_LOG(APP_LOG_LEVEL_INFO, "Meeting cost reached a budget step.");
+    vibes_double_pulse();
+  }
+  // Otherwise the timer was capped at BUDGET_TIMER_MAX_SECS; keep going.
+  comm_scheduleBudgetAlarm();
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Arms a single timer for the moment the meeting cost reaches the next
+/// multiple of the budget step. The moment is computed from the current
+/// rate, so nothing needs to check the cost as it runs; this must be
+/// called again whenever the rate or the budget step changes. A moment
+/// more than BUDGET_TIMER_MAX_SECS away is reached in several timers.
+/////////////////////////////////////////////////////////////////////////////
+void comm_scheduleBudgetAlarm() {
+  MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
+
+  if (budgetTimer != NULL) { app_timer_cancel(budgetTimer);  budgetTimer = NULL; }
+  budgetNextMilliCost = 0;
+  if ( (dataModel == NULL) || (budgetStep == 0) ) return;
+
+  uint64_t centiCost = 0;
+  if ( (mpaRet = Model_getCentiMeetingCost(dataModel, &centiCost)) != MPA_SUCCESS) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Error reading meeting cost: %s", MagPebApp_getErrMsg(mpaRet));
+    return;
+  }
+  uint64_t stepMilliCost = (uint64_t)budgetStep * 1000;
+  uint64_t nextMilliCost = ((centiCost * 10) / stepMilliCost + 1) * stepMilliCost;
+
+  time_t alarmTS = 0;
+  if ( (mpaRet = Model_getCostReachedTS(dataModel, nextMilliCost, &alarmTS)) != MPA_SUCCESS) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Error computing budget alarm: %s", MagPebApp_getErrMsg(mpaRet));
+    return;
+  }
+  // The cost isn't rising, so there is nothing to alarm about.
+  if (alarmTS == 0) return;
+
+  time_t nowSecs = 0;
+  uint16_t nowMs = 0;
+  Model_getTime(dataModel, &nowSecs, &nowMs);
+
+  // At the lowest rates a step can be weeks away, past what fits in the
+  // delay; wake up sooner and re-arm from there.
+  uint32_t delayMs = 0;
+  if (alarmTS > nowSecs + (time_t)BUDGET_TIMER_MAX_SECS) {
+    delayMs = BUDGET_TIMER_MAX_SECS * 1000;
+  } else if (alarmTS > nowSecs) {
+    delayMs = (uint32_t)(alarmTS - nowSecs) * 1000 - nowMs + UPDATE_TIMER_SLACK_MS;
+  }
+  budgetNextMilliCost = nextMilliCost;
+  budgetTimer = app_timer_register(delayMs, comm_budgetTimerCallback, NULL);
 }
 
 
@@ -484,6 +1187,50 @@ void comm_setHandlers(const CommHandlers cmh) {
 }
 
 
+/////////////////////////////////////////////////////////////////////////////
+/// Registers a handler to be called when any of the specified Model fields
+/// change. The handler is passed only the changed fields it asked for.
+/// @param[in]      handler  Function to call when fields change
+/// @param[in]      interest  Mask of the fields the handler cares about
+/// @return  true if the handler was registered (or already was)
+///          false if the subscriber table is full
+/////////////////////////////////////////////////////////////////////////////
+bool comm_subscribe(const ModelChangeHandler handler, const Model_FieldMask interest) {
+  if (handler == NULL) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Attempted operation on NULL pointer.");
+    return false;
+  }
+
+  int freeIdx = -1;
+  for (int idx=0; idx<MAX_SUBSCRIBERS; idx++) {
+    if (subscribers[idx].handler == handler) {
+      subscribers[idx].interest = interest;
+      return true;
+    }
+    if ( (freeIdx < 0) && (subscribers[idx].handler == NULL) ) freeIdx = idx;
+  }
+
+  if (freeIdx < 0) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "No room for another subscriber.");
+    return false;
+  }
+  subscribers[freeIdx] = (Subscriber) { .handler = handler, .interest = interest };
+  return true;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Removes a handler registered with comm_subscribe.
+/////////////////////////////////////////////////////////////////////////////
+void comm_unsubscribe(const ModelChangeHandler handler) {
+  for (int idx=0; idx<MAX_SUBSCRIBERS; idx++) {
+    if (subscribers[idx].handler == handler) {
+      subscribers[idx] = (Subscriber) { .handler = NULL, .interest = 0 };
+    }
+  }
+}
+
+
 /////////////////////////////////////////////////////////////////////////////
 /// Opens communication to PebbleKit and allocates memory.
 /////////////////////////////////////////////////////////////////////////////
@@ -491,15 +1238,55 @@ void comm_open() {
   dataModel = NULL;
   if ( (dataModel = Model_create("")) == NULL) { APP_LOG(APP_LOG_LEVEL_ERROR, "Could not initialize data model."); }
 
-  strSettings = NULL;
-  if ( (strSettings = calloc(LAST_STR_SETTING, sizeof(*strSettings)) ) == NULL) { goto freemem; }
-  // Initialize each string setting to NULL.
-  for (int idx=0; idx<LAST_STR_SETTING; idx++) {
-    strSettings[idx] = NULL;
+  memset(&settings, 0, sizeof(settings));
+  settingsWriteTimer = NULL;
+
+  // Apply the saved settings now, without waiting for the phone, so that
+  // the first frame shows them. Then pick up the meeting where it was.
+  comm_loadPersistent();
+  comm_loadCheckpoint();
+
+  // Only the history's header is read here; records are read on demand.
+  if ( (meetingHistory = History_create()) == NULL) { APP_LOG(APP_LOG_LEVEL_ERROR, "Could not initialize meeting history."); }
+  if ( (meetingRollup = Rollup_create()) == NULL) { APP_LOG(APP_LOG_LEVEL_ERROR, "Could not initialize meeting rollups."); }
+
+  // Budget alarms are timed by the app while it is open. A wakeup stood in
+  // for the timer while it was closed; if that is what launched the app,
+  // the budget was just crossed.
+  budgetTimer = NULL;
+  wakeup_cancel_all();
+  if (launch_reason() == APP_LAUNCH_WAKEUP) {
+    vibes_double_pulse();
   }
+  comm_scheduleBudgetAlarm();
 
   sendBuffer = NULL;
-  if ( (sendBuffer = RingBuffer_create(SEND_BUF_SIZE)) == NULL) { APP_LOG(APP_LOG_LEVEL_ERROR, "Could not initialize send buffer."); }
+  inFlightCount = 0;
+  // All queue storage, payloads included, is allocated here, once.
+  if ( (sendBuffer = SlotQueue_create(SEND_BUF_SIZE, sizeof(MsgSlot))) == NULL) { APP_LOG(APP_LOG_LEVEL_ERROR, "Could not initialize send buffer."); }
+
+  // Give every subscriber its initial data
+  memset(&seenGenerations, 0, sizeof(seenGenerations));
+  if (dataModel != NULL) {
+    Model_FieldMask changed = 0;
+    Model_getChanges(dataModel, &seenGenerations, &changed);
+    comm_notifySubscribers(MODEL_FIELDS_ALL);
+  }
+
+  // Suspend view updates whenever something covers the app
+  appInFocus = true;
+  if ( (focusGate = PublishGate_create()) == NULL) { APP_LOG(APP_LOG_LEVEL_ERROR, "Could not initialize focus gate."); }
+  app_focus_service_subscribe_handlers((AppFocusHandlers) {
+    .will_focus = comm_focusWillChange,
+    .did_focus = comm_focusDidChange
+  });
+
+  // Seed the retry jitter, and start out paused if there is no phone
+  srand(time(NULL));
+  phoneConnected = connection_service_peek_pebble_app_connection();
+  connection_service_subscribe((ConnectionHandlers) {
+    .pebble_app_connection_handler = comm_connectionHandler
+  });
 
   // Register callbacks
   app_message_register_inbox_received(inbox_received_callback);
@@ -508,14 +1295,7 @@ void comm_open() {
   app_message_register_outbox_sent(outbox_sent_callback);
 
   // Open AppMessage
-  // JRB TODO: Adjust message queue size appropriately.
-  app_message_open(300, 300);
-
-  return;
-
-freemem:
-  APP_LOG(APP_LOG_LEVEL_ERROR, "Error... freeing memory");
-  if (strSettings != NULL) { free(strSettings);  strSettings = NULL; }
+  app_message_open(COMM_INBOX_SIZE, COMM_OUTBOX_SIZE);
 }
 
 
@@ -523,20 +1303,45 @@ freemem:
 /// Closes communication and frees memory.
 /////////////////////////////////////////////////////////////////////////////
 void comm_close() {
+  if (updateTimer != NULL) { app_timer_cancel(updateTimer);  updateTimer = NULL; }
+
+  // Write any pending settings change while the Model is still around.
+  if (settingsWriteTimer != NULL) { comm_flushPersistent(); }
+
+  // Hand the next budget alarm over to the wakeup service.
+  if (budgetTimer != NULL) {
+    app_timer_cancel(budgetTimer);  budgetTimer = NULL;
+    time_t alarmTS = 0;
+    if ( (Model_getCostReachedTS(dataModel, budgetNextMilliCost, &alarmTS) == MPA_SUCCESS) && (alarmTS != 0) ) {
+      WakeupId wakeupId = wakeup_schedule(alarmTS, BUDGET_WAKEUP_COOKIE, true);
+      if (wakeupId < 0) {
+        APP_LOG(APP_LOG_LEVEL_WARNING, "Could not schedule budget wakeup: %ld", wakeupId);
+      }
+    }
+  }
+
+  if (meetingHistory != NULL) {
+    History_destroy(meetingHistory);  meetingHistory = NULL;
+  }
+  if (meetingRollup != NULL) {
+    Rollup_destroy(meetingRollup);  meetingRollup = NULL;
+  }
   if (dataModel != NULL) {
     Model_destroy(dataModel);  dataModel = NULL;
   }
 
-  if (sendBuffer != NULL) {
-    RingBuffer_destroy(sendBuffer);  sendBuffer = NULL;
+  APP_LOG(APP_LOG_LEVEL_INFO, "Skipped %lu redraws while out of focus.", (unsigned long)comm_getSkippedRedraws());
+  app_focus_service_unsubscribe();
+  if (focusGate != NULL) {
+    PublishGate_destroy(focusGate);  focusGate = NULL;
   }
-
-  if (strSettings != NULL) {
-    for (int idx=0; idx<LAST_STR_SETTING; idx++) {
-      if (strSettings[idx] != NULL) { free(strSettings[idx]); strSettings[idx] = NULL; }
-    }
-    if (strSettings != NULL) { free(strSettings); strSettings = NULL; }
+  connection_service_unsubscribe();
+  if (sendRetryTimer != NULL) { app_timer_cancel(sendRetryTimer);  sendRetryTimer = NULL; }
+  sendRetryCount = 0;
+  if (sendBuffer != NULL) {
+    SlotQueue_destroy(sendBuffer);  sendBuffer = NULL;
   }
+  inFlightCount = 0;
 
   app_message_deregister_callbacks();
 }
@@ -557,11 +1362,12 @@ void comm_adjustAttendance(const int16_t attenIncr, const uint16_t attenSalary)
     return;
   }
 
-  if (!commHandlers.updateViewData) {
-    APP_LOG(APP_LOG_LEVEL_ERROR, "Attempted operation on NULL pointer.");
-  } else {
-    (*commHandlers.updateViewData)(dataModel);
-  }
+  comm_publishChanges();
+  comm_saveCheckpoint();
+  comm_scheduleBudgetAlarm();
+
+  // The meeting changed, so the next visible change moved.
+  comm_scheduleUpdate();
 
 }
 
@@ -602,12 +1408,88 @@ void comm_toggleMeeting() {
     }
   }
 
-  if (!commHandlers.updateViewData) {
-    APP_LOG(APP_LOG_LEVEL_ERROR, "Attempted operation on NULL pointer.");
-  } else {
-    (*commHandlers.updateViewData)(dataModel);
+  comm_publishChanges();
+  comm_saveCheckpoint();
+  comm_scheduleBudgetAlarm();
+
+  // The meeting changed, so the next visible change moved.
+  comm_scheduleUpdate();
+
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Adds the meeting to the history and the rollups, as it stands. Meetings
+/// that never started are not recorded.
+/////////////////////////////////////////////////////////////////////////////
+static void comm_recordMeeting() {
+  if (dataModel == NULL) return;
+
+  MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
+  Model_Summary summary;
+  if ( (mpaRet = Model_getSummary(dataModel, &summary)) != MPA_SUCCESS) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Could not sum up the meeting: %s", MagPebApp_getErrMsg(mpaRet));
+    return;
+  }
+  if (summary.startTS == 0) return;
+
+  History_Record record = {
+    .startTS = (uint32_t)summary.startTS,
+    .durationSecs = summary.durationSecs,
+    .peakAttendees = summary.peakAttendees,
+    .milliCost = summary.milliCost
+  };
+  char* currSym = NULL;
+  if ( (Model_getCurrencySymbol(dataModel, &currSym) != MPA_SUCCESS) ||
+       !strxcpy(record.currencySymbol, sizeof(record.currencySymbol), currSym, "Currency symbol") ) {
+    record.currencySymbol[0] = '\0';
+  }
+
+  if ( (meetingHistory != NULL) && ((mpaRet = History_append(meetingHistory, &record)) != MPA_SUCCESS) ) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Could not record the meeting: %s", MagPebApp_getErrMsg(mpaRet));
   }
+  if ( (meetingRollup != NULL) && ((mpaRet = Rollup_addMeeting(meetingRollup, summary.startTS, summary.durationSecs, summary.milliCost, record.currencySymbol)) != MPA_SUCCESS) ) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Could not add the meeting to the rollups: %s", MagPebApp_getErrMsg(mpaRet));
+  }
+}
 
+
+/////////////////////////////////////////////////////////////////////////////
+/// Gets the number of past meetings. This comes from the history's header,
+/// so it doesn't read any meetings.
+/////////////////////////////////////////////////////////////////////////////
+bool comm_getHistoryCount(size_t* count) {
+  if (meetingHistory == NULL) return false;
+  return (History_count(meetingHistory, count) == MPA_SUCCESS);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Gets a past meeting; 0 is the most recent.
+/////////////////////////////////////////////////////////////////////////////
+bool comm_getHistoryRecord(const size_t index, History_Record* record) {
+  if (meetingHistory == NULL) return false;
+
+  MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
+  if ( (mpaRet = History_getRecord(meetingHistory, index, record)) != MPA_SUCCESS) {
+    APP_LOG(APP_LOG_LEVEL_WARNING, "Could not read past meeting %u: %s", (unsigned)index, MagPebApp_getErrMsg(mpaRet));
+    return false;
+  }
+  return true;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Gets the totals of past meetings for the current day, week or month,
+/// and the currency they are in (which need not be the current one).
+/////////////////////////////////////////////////////////////////////////////
+bool comm_getRollup(const Rollup_Period period, Rollup_Bucket* current, const char** currencySymbol) {
+  if ( (meetingRollup == NULL) || (dataModel == NULL) ) return false;
+
+  time_t now = 0;
+  if (Model_getTime(dataModel, &now, NULL) != MPA_SUCCESS) return false;
+  return (Rollup_get(meetingRollup, period, now, current, NULL) == MPA_SUCCESS) &&
+         (Rollup_getCurrencySymbol(meetingRollup, currencySymbol) == MPA_SUCCESS);
 }
 
 
@@ -620,17 +1502,21 @@ void comm_resetMeeting() {
     return;
   }
 
+  // The meeting is over; keep it before it's gone.
+  comm_recordMeeting();
+
   MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
   if ( (mpaRet = Model_reset(dataModel)) != MPA_SUCCESS) {
     APP_LOG(APP_LOG_LEVEL_ERROR, "Error encountered: %s", MagPebApp_getErrMsg(mpaRet));
     return;
   }
 
-  if (!commHandlers.updateViewData) {
-    APP_LOG(APP_LOG_LEVEL_ERROR, "Attempted operation on NULL pointer.");
-  } else {
-    (*commHandlers.updateViewData)(dataModel);
-  }
+  comm_publishChanges();
+  comm_saveCheckpoint();
+  comm_scheduleBudgetAlarm();
+
+  // The meeting changed, so the next visible change moved.
+  comm_scheduleUpdate();
 
 }
 
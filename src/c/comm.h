@@ -1,24 +1,53 @@
 #pragma once
 
+#include "data/History.h"
 #include "data/Model.h"
-
-typedef struct ClaySettings {
-  uint8_t settingsVer;
+#include "data/Rollup.h"
+#include "libs/SlotQueue.h"
+
+// Version of the ClaySettings layout. Bump it, and teach
+// comm_loadPersistent to migrate the previous layout, whenever the
+// struct changes.
+#define SETTINGS_VER 3
+#define SETTINGS_CURRENCY_SZ 8
+
+// All settings, persisted as one record. Packed, with fixed widths and
+// strings inline, so its bytes are the storage format.
+typedef struct __attribute__((__packed__)) ClaySettings {
+  uint8_t  settingsVer;                              ///< SETTINGS_VER
   uint32_t defaultMilliHourly;
+  char     currencySymbol[SETTINGS_CURRENCY_SZ];     ///< NUL-terminated
+  uint32_t budgetStep;                               ///< whole currency units between budget alarms; 0 for none
 } ClaySettings;
 
 
-// Setting string definitions
-typedef enum StrSettings {
-  CURRENCY_SYMBOL_SETTING  = 0,
+// Message payload types
+typedef enum MessageType {
+  MSG_TYPE_CSTRING = 0,
+  MSG_TYPE_INT32,
+  MSG_TYPE_UINT32,
+  MSG_TYPE_DATA,
+
+  LAST_MSG_TYPE
+} MessageType;
 
-  LAST_STR_SETTING
-} StrSettings;
 
+// Largest payload a buffered message can carry (bytes, including a
+// string's terminator). comm_enqMsg copies the payload into the queue.
+#define COMM_MSG_PAYLOAD_SZ 32
 
 typedef struct Message {
-  uint32_t  key;
-  char*     payload;
+  uint32_t     key;
+  MessageType  type;
+  union {
+    const char*      cstring;     ///< MSG_TYPE_CSTRING
+    int32_t          int32;       ///< MSG_TYPE_INT32
+    uint32_t         uint32;      ///< MSG_TYPE_UINT32
+    struct {
+      const uint8_t* bytes;
+      uint16_t       length;
+    } data;                       ///< MSG_TYPE_DATA
+  } payload;
 } Message;
 
 
@@ -26,14 +55,13 @@ typedef struct Message {
 // parameter (struct tm pointer) and returns nothing.
 typedef void (*UpdateViewTimeHandler)(struct tm*);
 
-// UpdateViewDataHandler is a pointer to a function that takes a single
-// parameter (const Model pointer) and returns nothing.
-typedef void (*UpdateViewDataHandler)(const Model*);
+// ModelChangeHandler is a pointer to a function that takes two parameters
+// (const Model pointer, mask of the fields that changed) and returns nothing.
+typedef void (*ModelChangeHandler)(const Model*, const Model_FieldMask);
 
 // CommHandlers is a struct that contains the values of the handlers.
 typedef struct CommHandlers {
   UpdateViewTimeHandler  updateViewTime;      ///< Function that Comm calls to notify the View of a time update.
-  UpdateViewDataHandler  updateViewData;      ///< Function that Comm calls to notify the View of a data model update.
 } CommHandlers;
 
 
@@ -42,7 +70,7 @@ void comm_open();
 void comm_close();
 
 // For buffered sending
-void comm_enqMsg(Message*);
+bool comm_enqMsg(const Message*, const SlotQueue_FullPolicy);
 void comm_sendBufMsg();
 void comm_startResendTimer();
 
@@ -50,8 +78,22 @@ void comm_startResendTimer();
 void comm_sendMsg(const Message*);
 
 void comm_tickHandler(struct tm *tick_time, TimeUnits units_changed);
+void comm_scheduleUpdate();
+void comm_scheduleBudgetAlarm();
+uint32_t comm_getSkippedRedraws();
 void comm_setHandlers(const CommHandlers);
 
+// For model change notification
+bool comm_subscribe(const ModelChangeHandler, const Model_FieldMask);
+void comm_unsubscribe(const ModelChangeHandler);
+
+void comm_publishGlance();
+
+// For past meetings
+bool comm_getHistoryCount(size_t*);
+bool comm_getHistoryRecord(const size_t, History_Record*);
+bool comm_getRollup(const Rollup_Period, Rollup_Bucket*, const char**);
+
 void comm_savePersistent();
 void comm_loadPersistent();
 
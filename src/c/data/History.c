@@ -0,0 +1,266 @@
+#include <pebble.h>
+
+// Deactivate APP_LOG in this file.
+#undef APP_LOG
+#define APP_LOG(...)
+
+#include "History_Internal.h"
+
+
+#define HISTORY_BLOCK_HDR_SZ (offsetof(History_Block, data))
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Constructor. A History is the list of completed meetings, kept in
+/// persistent storage. Only its header is held in memory; records are
+/// read from storage one at a time, and appending writes a single block.
+///
+/// JRB NOTE: Blocks form a ring. Records are appended to the head block
+/// until it is full, then the head moves on to the next block. Every
+/// append rewrites the head block's key, so wear moves from key to key a
+/// block at a time, not a record at a time. Once the ring is full, moving
+/// on overwrites the oldest block, and its meetings are forgotten.
+/////////////////////////////////////////////////////////////////////////////
+History* History_create() {
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "Creating History");
+  int mpaRet;
+
+  History* newHistory = malloc(sizeof(*newHistory));
+  if ( (mpaRet = History_init(newHistory)) != MPA_SUCCESS) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Could not initialize: %s", MagPebApp_getErrMsg(mpaRet));
+    if (newHistory != NULL) { History_destroy(newHistory);  newHistory = NULL; }
+  }
+
+  return newHistory;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Internal initialization. Reads the header, and the head block's count.
+/// @param[in,out]  this  Pointer to History; must be already allocated
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode History_init(History* this) {
+  MPA_RETURN_IF_NULL(this);
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "Initializing History");
+
+  memset(&this->header, 0, sizeof(this->header));
+  this->headCount = 0;
+  this->count = 0;
+
+  History_Header header;
+  if ( (persist_read_data(HISTORY_HEADER_KEY, &header, sizeof(header)) != (int)sizeof(header)) ||
+       (header.historyVer != HISTORY_VER) ||
+       (header.numBlocks == 0) || (header.numBlocks > HISTORY_NUM_BLOCKS) ||
+       (header.headBlock >= HISTORY_NUM_BLOCKS) ) {
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "No history.");
+    return MPA_SUCCESS;
+  }
+
+  // Only the head block's own header is read (its version and count).
+  uint8_t blockHdr[HISTORY_BLOCK_HDR_SZ];
+  uint8_t headCount = 0;
+  if ( (persist_read_data(HISTORY_BLOCK_KEY + header.headBlock, blockHdr, sizeof(blockHdr)) == (int)sizeof(blockHdr)) &&
+       (blockHdr[offsetof(History_Block, historyVer)] == HISTORY_VER) ) {
+    headCount = blockHdr[offsetof(History_Block, count)];
+  }
+
+  this->header = header;
+  this->headCount = headCount;
+  History_recount(this);
+
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Counts the records from the header; no blocks are read.
+/// @param[in,out]  this  Pointer to History; must be already allocated
+/////////////////////////////////////////////////////////////////////////////
+void History_recount(History* this) {
+  if (this == NULL) return;
+
+  this->count = this->headCount;
+  for (uint8_t idx=1; idx<this->header.numBlocks; idx++) {
+    uint8_t block = (this->header.headBlock + HISTORY_NUM_BLOCKS - idx) % HISTORY_NUM_BLOCKS;
+    this->count += this->header.blockCounts[block];
+  }
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Destroys History and frees allocated memory. The history itself stays
+/// in persistent storage.
+/// @param[in,out]  this  Pointer to History; must be already allocated
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode History_destroy(History* this) {
+  MPA_RETURN_IF_NULL(this);
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "Destroying History");
+
+  free(this); this = NULL;
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Reads a block and checks that it holds the records it should.
+/// @param[in]      blockIdx  Which block
+/// @param[in]      count   Records the block should hold
+/// @param[out]     block   Caller-owned block to read into
+/// @param[out]     dataLen   Length of the block's encoded records
+/// @return  MPA_SUCCESS on success
+///          MPA_EMPTY_ERR if the block could not be read, or doesn't match.
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode History_readBlock(const uint8_t blockIdx, const uint8_t count, History_Block* block, size_t* dataLen) {
+  MPA_RETURN_IF_NULL(block);
+  MPA_RETURN_IF_NULL(dataLen);
+
+  int size = persist_read_data(HISTORY_BLOCK_KEY + blockIdx, block, sizeof(*block));
+  if ( (size < (int)HISTORY_BLOCK_HDR_SZ) || (block->historyVer != HISTORY_VER) || (block->count != count) ) {
+    return MPA_EMPTY_ERR;
+  }
+  *dataLen = size - HISTORY_BLOCK_HDR_SZ;
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Appends a completed meeting. This reads and writes the head block only
+/// (and the header, when the head moves on to the next block). The head
+/// block is decoded to find its last record, which the new one is encoded
+/// against.
+/// @param[in,out]  this  Pointer to History; must be already allocated
+/// @param[in]      record   The meeting
+/// @return  MPA_SUCCESS on success
+///          MPA_NULL_POINTER_ERR if a pointer is NULL.
+///          MPA_OUT_OF_MEMORY_ERR if the block can't be read in.
+///          MPA_UNKNOWN_ERR if persistent storage could not be written.
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode History_append(History* this, const History_Record* record) {
+  MPA_RETURN_IF_NULL(this);
+  MPA_RETURN_IF_NULL(record);
+  MagPebApp_ErrCode myRet = MPA_SUCCESS;
+  status_t result = 0;
+
+  History_Block* block = malloc(sizeof(*block));
+  if (block == NULL) { return MPA_OUT_OF_MEMORY_ERR; }
+
+  History_Header header = this->header;
+  size_t dataLen = 0;
+  HistoryCodec_Decoder decoder;
+  if (header.numBlocks == 0) {
+    // The first record ever: start the ring.
+    header.historyVer = HISTORY_VER;
+    header.headBlock = 0;
+    header.numBlocks = 1;
+  } else if ( (this->headCount > 0) && (History_readBlock(header.headBlock, this->headCount, block, &dataLen) == MPA_SUCCESS) ) {
+    HistoryCodec_startDecode(&decoder, block->data, dataLen);
+    while (HistoryCodec_decodeNext(&decoder, NULL) == MPA_SUCCESS) { }
+    if (decoder.cursor != block->data + dataLen) { dataLen = 0; }
+  }
+  if (dataLen == 0) {
+    // Empty, or lost; start the head block over.
+    block->count = 0;
+    decoder.hasLast = false;
+  }
+
+  size_t encodedLen = 0;
+  const History_Record* prev = decoder.hasLast ? &decoder.last : NULL;
+  if (HistoryCodec_encode(prev, record, block->data + dataLen, HISTORY_BLOCK_DATA_SZ - dataLen, &encodedLen) == MPA_FULL_ERR) {
+    // Move on to the next block, overwriting the oldest if the ring is full.
+    header.blockCounts[header.headBlock] = block->count;
+    header.headBlock = (header.headBlock + 1) % HISTORY_NUM_BLOCKS;
+    if (header.numBlocks < HISTORY_NUM_BLOCKS) header.numBlocks++;
+    block->count = 0;
+    dataLen = 0;
+    HistoryCodec_encode(NULL, record, block->data, HISTORY_BLOCK_DATA_SZ, &encodedLen);
+  }
+
+  // The block goes first. Until the header points at it, the old head is
+  // still the head; a recycled block's stale count is never read as the
+  // head's, so overwritten meetings can't come back as the newest.
+  block->historyVer = HISTORY_VER;
+  block->count++;
+  dataLen += encodedLen;
+  if ( (result = persist_write_data(HISTORY_BLOCK_KEY + header.headBlock, block, HISTORY_BLOCK_HDR_SZ + dataLen)) < 0) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Could not write history block. Error: %ld", result);
+    myRet = MPA_UNKNOWN_ERR;  goto freemem;
+  }
+
+  if ( (header.numBlocks != this->header.numBlocks) || (header.headBlock != this->header.headBlock) ) {
+    header.blockCounts[header.headBlock] = 0;
+    if ( (result = persist_write_data(HISTORY_HEADER_KEY, &header, sizeof(header))) < 0) {
+      APP_LOG(APP_LOG_LEVEL_ERROR, "Could not write history header. Error: %ld", result);
+      myRet = MPA_UNKNOWN_ERR;  goto freemem;
+    }
+  }
+
+  this->header = header;
+  this->headCount = block->count;
+  History_recount(this);
+
+freemem:
+  free(block);  block = NULL;
+  return myRet;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Gets the number of meetings in the history.
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode History_count(const History* this, size_t* count) {
+  MPA_RETURN_IF_NULL(this);
+  MPA_RETURN_IF_NULL(count);
+  *count = this->count;
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Gets one meeting from the history. Only the block holding it is read,
+/// and it is decoded only up to the meeting.
+/// @param[in,out]  this  Pointer to History; must be already allocated
+/// @param[in]      index   Which meeting; 0 is the most recent.
+/// @param[out]     record  The meeting
+/// @return  MPA_SUCCESS on success
+///          MPA_NULL_POINTER_ERR if a pointer is NULL.
+///          MPA_INVALID_INPUT_ERR if there is no such meeting.
+///          MPA_OUT_OF_MEMORY_ERR if the block can't be read in.
+///          MPA_EMPTY_ERR if the block holding it could not be read.
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode History_getRecord(const History* this, const size_t index, History_Record* record) {
+  MPA_RETURN_IF_NULL(this);
+  MPA_RETURN_IF_NULL(record);
+  MagPebApp_ErrCode myRet = MPA_SUCCESS;
+
+  if (index >= this->count) { return MPA_INVALID_INPUT_ERR; }
+
+  // Walk back from the head block to the one holding the meeting.
+  uint8_t block = this->header.headBlock;
+  size_t blockCount = this->headCount;
+  size_t fromNewest = index;
+  while (fromNewest >= blockCount) {
+    fromNewest -= blockCount;
+    block = (block + HISTORY_NUM_BLOCKS - 1) % HISTORY_NUM_BLOCKS;
+    blockCount = this->header.blockCounts[block];
+  }
+  size_t position = blockCount - 1 - fromNewest;
+
+  History_Block* buf = malloc(sizeof(*buf));
+  if (buf == NULL) { return MPA_OUT_OF_MEMORY_ERR; }
+
+  // Records are encoded against each other, so decode up to this one.
+  size_t dataLen = 0;
+  if ( (myRet = History_readBlock(block, (uint8_t)blockCount, buf, &dataLen)) != MPA_SUCCESS) goto freemem;
+
+  HistoryCodec_Decoder decoder;
+  HistoryCodec_startDecode(&decoder, buf->data, dataLen);
+  for (size_t idx=0; idx<=position; idx++) {
+    if ( (myRet = HistoryCodec_decodeNext(&decoder, record)) != MPA_SUCCESS) {
+      myRet = MPA_EMPTY_ERR;  goto freemem;
+    }
+  }
+
+freemem:
+  free(buf);  buf = NULL;
+  return myRet;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <pebble.h>
+#include "../libs/magpebapp.h"
+
+
+// The history lives in persistent storage: a header key, then a ring of
+// block keys that records are appended to in turn.
+#define HISTORY_HEADER_KEY   0x1100
+#define HISTORY_BLOCK_KEY    0x1101   ///< key of block 0; block n is at HISTORY_BLOCK_KEY + n
+#define HISTORY_NUM_BLOCKS   12
+
+#define HISTORY_CURRENCY_SZ  8
+
+
+// One completed meeting (stored encoded; see HistoryCodec)
+typedef struct History_Record {
+  uint32_t startTS;                              ///< when the meeting first started
+  uint32_t durationSecs;                         ///< time spent running (pauses are not counted)
+  uint16_t peakAttendees;
+  uint64_t milliCost;                            ///< total cost, in thousandths of currency units
+  char     currencySymbol[HISTORY_CURRENCY_SZ];  ///< currency the cost is in (null-terminated)
+} History_Record;
+
+
+// History struct typedef
+typedef struct History History;
+
+
+History* History_create();
+MagPebApp_ErrCode History_destroy(History* this);
+
+MagPebApp_ErrCode History_append(History* this, const History_Record*);
+MagPebApp_ErrCode History_count(const History* this, size_t*);
+MagPebApp_ErrCode History_getRecord(const History* this, const size_t, History_Record*);
@@ -0,0 +1,175 @@
+#include <pebble.h>
+
+// Deactivate APP_LOG in this file.
+#undef APP_LOG
+#define APP_LOG(...)
+
+#include "HistoryCodec.h"
+
+
+// JRB NOTE: Records are encoded as a run, each against the one before it:
+//
+//   varint  start time, as a zigzagged delta from the previous start
+//   varint  duration, in seconds
+//   varint  (peak attendees << 1) | currency-changed flag
+//   varint  total cost, in thousandths of currency units
+//   [if the flag is set]  length byte, then the currency symbol's bytes
+//
+// Varints are little-endian groups of 7 bits, with the top bit set on every
+// byte but the last. The first record of a run has no previous record, so
+// its start is a delta from 0 and its currency is always written. A typical
+// meeting takes 8 to 10 bytes.
+
+#define HISTORYCODEC_CURRENCY_FLAG 0x01
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Writes a varint. The buffer must have room for it.
+/////////////////////////////////////////////////////////////////////////////
+static uint8_t* HistoryCodec_putVarint(uint8_t* cursor, uint64_t value) {
+  while (value >= 0x80) {
+    *cursor++ = (uint8_t)(value | 0x80);
+    value >>= 7;
+  }
+  *cursor++ = (uint8_t)value;
+  return cursor;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Reads a varint of at most maxBits bits.
+/// @return  false if the bytes run out or the value is too large
+/////////////////////////////////////////////////////////////////////////////
+static bool HistoryCodec_getVarint(HistoryCodec_Decoder* decoder, uint64_t* value, const uint8_t maxBits) {
+  uint64_t result = 0;
+  for (uint8_t shift=0; shift<maxBits; shift+=7) {
+    if (decoder->cursor >= decoder->end) return false;
+    uint8_t byte = *decoder->cursor++;
+    // The last group of a 64-bit value has a single bit left.
+    if ( (shift + 7 > 64) && (((byte & 0x7F) >> (64 - shift)) != 0) ) return false;
+    result |= (uint64_t)(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) {
+      if ( (maxBits < 64) && ((result >> maxBits) != 0) ) return false;
+      *value = result;
+      return true;
+    }
+  }
+  return false;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Encodes a record against the one before it.
+/// @param[in]      prev  The previous record of the run, or NULL if this
+///       is the first record of the run.
+/// @param[in]      record   The record to encode
+/// @param[out]     buf   Where to write the encoded record
+/// @param[in]      bufsize   Room in buf, in bytes
+/// @param[out]     length   Bytes written
+/// @return  MPA_SUCCESS on success
+///          MPA_NULL_POINTER_ERR if a pointer is NULL.
+///          MPA_FULL_ERR if the record doesn't fit in buf (nothing is
+///          written).
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode HistoryCodec_encode(const History_Record* prev, const History_Record* record, uint8_t* buf, const size_t bufsize, size_t* length) {
+  MPA_RETURN_IF_NULL(record);
+  MPA_RETURN_IF_NULL(buf);
+  MPA_RETURN_IF_NULL(length);
+
+  size_t currencyLen = 0;
+  while ( (currencyLen < HISTORY_CURRENCY_SZ - 1) && (record->currencySymbol[currencyLen] != '\0') ) currencyLen++;
+  bool currencyChanged = (prev == NULL) ||
+                         (strncmp(prev->currencySymbol, record->currencySymbol, HISTORY_CURRENCY_SZ) != 0);
+
+  int64_t startDelta = (int64_t)record->startTS - (int64_t)((prev != NULL) ? prev->startTS : 0);
+  uint64_t zigzag = (startDelta < 0) ? (((uint64_t)(-startDelta) << 1) - 1) : ((uint64_t)startDelta << 1);
+
+  uint8_t scratch[HISTORYCODEC_MAX_RECORD_SZ];
+  uint8_t* cursor = scratch;
+  cursor = HistoryCodec_putVarint(cursor, zigzag);
+  cursor = HistoryCodec_putVarint(cursor, record->durationSecs);
+  cursor = HistoryCodec_putVarint(cursor, ((uint32_t)record->peakAttendees << 1) | (currencyChanged ? HISTORYCODEC_CURRENCY_FLAG : 0));
+  cursor = HistoryCodec_putVarint(cursor, record->milliCost);
+  if (currencyChanged) {
+    *cursor++ = (uint8_t)currencyLen;
+    memcpy(cursor, record->currencySymbol, currencyLen);
+    cursor += currencyLen;
+  }
+
+  size_t encodedLen = cursor - scratch;
+  if (encodedLen > bufsize) { return MPA_FULL_ERR; }
+  memcpy(buf, scratch, encodedLen);
+  *length = encodedLen;
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Starts decoding a run of records. The bytes are not copied, so they
+/// must outlive the decoding.
+/// @param[out]     decoder   Caller-owned decoder
+/// @param[in]      bytes   The encoded run
+/// @param[in]      length   Length of the run, in bytes
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode HistoryCodec_startDecode(HistoryCodec_Decoder* decoder, const uint8_t* bytes, const size_t length) {
+  MPA_RETURN_IF_NULL(decoder);
+  MPA_RETURN_IF_NULL(bytes);
+
+  decoder->cursor = bytes;
+  decoder->end = bytes + length;
+  memset(&decoder->last, 0, sizeof(decoder->last));
+  decoder->hasLast = false;
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Decodes the next record of the run.
+/// @param[in,out]  decoder   Decoder set up by HistoryCodec_startDecode
+/// @param[out]     record   The record; may be NULL to skip it.
+/// @return  MPA_SUCCESS on success
+///          MPA_NULL_POINTER_ERR if the decoder pointer is NULL.
+///          MPA_EMPTY_ERR at the end of the run.
+///          MPA_INVALID_INPUT_ERR if the run is garbled (decoding stops).
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode HistoryCodec_decodeNext(HistoryCodec_Decoder* decoder, History_Record* record) {
+  MPA_RETURN_IF_NULL(decoder);
+
+  if (decoder->cursor >= decoder->end) { return MPA_EMPTY_ERR; }
+
+  uint64_t zigzag = 0, durationSecs = 0, attendeesFlag = 0, milliCost = 0;
+  if ( !HistoryCodec_getVarint(decoder, &zigzag, 35) ||
+       !HistoryCodec_getVarint(decoder, &durationSecs, 32) ||
+       !HistoryCodec_getVarint(decoder, &attendeesFlag, 17) ||
+       !HistoryCodec_getVarint(decoder, &milliCost, 64) ) {
+    goto garbled;
+  }
+
+  History_Record next = decoder->last;
+  int64_t startDelta = (zigzag & 1) ? -(int64_t)((zigzag + 1) >> 1) : (int64_t)(zigzag >> 1);
+  next.startTS = (uint32_t)((int64_t)next.startTS + startDelta);
+  next.durationSecs = (uint32_t)durationSecs;
+  next.peakAttendees = (uint16_t)(attendeesFlag >> 1);
+  next.milliCost = milliCost;
+
+  if (attendeesFlag & HISTORYCODEC_CURRENCY_FLAG) {
+    if (decoder->cursor >= decoder->end) goto garbled;
+    uint8_t currencyLen = *decoder->cursor++;
+    if ( (currencyLen >= HISTORY_CURRENCY_SZ) || (currencyLen > (size_t)(decoder->end - decoder->cursor)) ) goto garbled;
+    memset(next.currencySymbol, 0, sizeof(next.currencySymbol));
+    memcpy(next.currencySymbol, decoder->cursor, currencyLen);
+    decoder->cursor += currencyLen;
+  } else if (!decoder->hasLast) {
+    goto garbled;
+  }
+
+  decoder->last = next;
+  decoder->hasLast = true;
+  if (record != NULL) *record = next;
+  return MPA_SUCCESS;
+
+garbled:
+  APP_LOG(APP_LOG_LEVEL_WARNING, "Garbled history record.");
+  decoder->cursor = decoder->end;
+  return MPA_INVALID_INPUT_ERR;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <pebble.h>
+#include "../libs/magpebapp.h"
+#include "History.h"
+
+
+// Largest encoded record, in bytes: start delta (5), duration (5),
+// attendees and currency flag (3), cost (10), then the currency symbol
+// with its length (1 + HISTORY_CURRENCY_SZ - 1).
+#define HISTORYCODEC_MAX_RECORD_SZ (5 + 5 + 3 + 10 + HISTORY_CURRENCY_SZ)
+
+
+// Decodes a run of encoded records, one at a time
+typedef struct HistoryCodec_Decoder {
+  const uint8_t* cursor;      ///< next byte to decode
+  const uint8_t* end;         ///< one past the last byte
+  History_Record last;        ///< the record decoded last; the base of the next one
+  bool           hasLast;
+} HistoryCodec_Decoder;
+
+
+MagPebApp_ErrCode HistoryCodec_encode(const History_Record* prev, const History_Record*, uint8_t*, const size_t, size_t*);
+
+MagPebApp_ErrCode HistoryCodec_startDecode(HistoryCodec_Decoder*, const uint8_t*, const size_t);
+MagPebApp_ErrCode HistoryCodec_decodeNext(HistoryCodec_Decoder*, History_Record*);
@@ -0,0 +1,41 @@
+#include <pebble.h>
+#include "History.h"
+#include "HistoryCodec.h"
+
+
+// Version of the history's storage layout. A history of another version
+// is ignored (and overwritten as new meetings are added).
+#define HISTORY_VER 2
+
+#define HISTORY_BLOCK_DATA_SZ (PERSIST_DATA_MAX_LENGTH - 2)
+
+
+// Persisted at HISTORY_HEADER_KEY. It only changes when appending moves on
+// to the next block, so it is written once per block, not once per record.
+typedef struct __attribute__((__packed__)) History_Header {
+  uint8_t historyVer;                        ///< HISTORY_VER
+  uint8_t headBlock;                         ///< block that records are being appended to
+  uint8_t numBlocks;                         ///< blocks in use, the head block included
+  uint8_t blockCounts[HISTORY_NUM_BLOCKS];   ///< records in each full block (the head block keeps its own count)
+} History_Header;
+
+// Persisted at HISTORY_BLOCK_KEY + n, as long as the records in it. The
+// records are a run encoded by HistoryCodec, oldest first; each block
+// starts a new run, so it decodes on its own.
+typedef struct __attribute__((__packed__)) History_Block {
+  uint8_t historyVer;                        ///< HISTORY_VER
+  uint8_t count;                             ///< records in this block
+  uint8_t data[HISTORY_BLOCK_DATA_SZ];
+} History_Block;
+
+
+struct History {
+  History_Header header;     ///< as persisted
+  uint8_t        headCount;  ///< records in the head block
+  size_t         count;      ///< records in the whole history
+};
+
+
+MagPebApp_ErrCode History_init(History* this);
+void History_recount(History* this);
+MagPebApp_ErrCode History_readBlock(const uint8_t, const uint8_t, History_Block*, size_t*);
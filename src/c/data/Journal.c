@@ -0,0 +1,443 @@
+#include <pebble.h>
+
+// Deactivate APP_LOG in this file.
+#undef APP_LOG
+#define APP_LOG(...)
+
+#include "Journal_Internal.h"
+#include "../misc.h"
+
+
+// Number of entries folded into the checkpoint at once when the journal
+// is full. Folding in batches keeps appends O(1) on average while still
+// bounding replay to the entries held.
+#define JOURNAL_FOLD_BATCH 8
+
+#define JOURNAL_ENTRY(J, IDX) (&(J)->entries[((J)->first + (IDX)) % (J)->capacity])
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Constructor. A Journal is an append-only log of the meeting's events
+/// (attendees joining or leaving, pauses, resumes and resets), kept in a
+/// fixed number of 9-byte entries allocated up front. A checkpoint holds
+/// the meeting as of the oldest entry, and a running tail the meeting as
+/// of the newest, so replay only ever touches the entries held.
+/// @param[in]      capacity   Number of entries the Journal can hold; at
+///       least JOURNAL_MAX_EVENT_ENTRIES.
+/// @param[in]      start   The meeting to start from; may be NULL for an
+///       empty meeting.
+/////////////////////////////////////////////////////////////////////////////
+Journal* Journal_create(size_t capacity, const Journal_Fold* start) {
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "Creating Journal [%zd]", capacity);
+  int mpaRet;
+
+  Journal* newJournal = malloc(sizeof(*newJournal));
+  if ( (mpaRet = Journal_init(newJournal, capacity, start)) != MPA_SUCCESS) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Could not initialize: %s", MagPebApp_getErrMsg(mpaRet));
+    newJournal = NULL;
+  }
+
+  return newJournal;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Internal initialization
+/// @param[in,out]  this  Pointer to Journal; must be already allocated
+/// @param[in]      capacity   Number of entries the Journal can hold.
+/// @param[in]      start   The meeting to start from; may be NULL.
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode Journal_init(Journal* this, size_t capacity, const Journal_Fold* start) {
+  MPA_RETURN_IF_NULL(this);
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "Initializing Journal [%zd]", capacity);
+  MagPebApp_ErrCode myRet = MPA_OUT_OF_MEMORY_ERR;
+
+  this->entries = NULL;
+  if (capacity < JOURNAL_MAX_EVENT_ENTRIES) { myRet = MPA_INVALID_INPUT_ERR; goto freemem; }
+  this->capacity = capacity;
+
+  this->entries = calloc(capacity, sizeof(*this->entries));
+  if (this->entries == NULL) { goto freemem; }
+
+  return Journal_restart(this, start);
+
+freemem:
+  APP_LOG(APP_LOG_LEVEL_ERROR, "Error... freeing memory");
+  if (this != NULL) {
+    Journal_destroy(this);  this = NULL;
+  }
+  return myRet;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Destroys Journal and frees the storage for its entries.
+/// @param[in,out]  this  Pointer to Journal; must be already allocated
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode Journal_destroy(Journal* this) {
+  MPA_RETURN_IF_NULL(this);
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "Destroying Journal");
+
+  if (this->entries != NULL) {
+    free(this->entries);
+    this->entries = NULL;
+  }
+
+  free(this); this = NULL;
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Discards every entry and starts the Journal over from a known meeting
+/// (eg. one restored from persistent storage).
+/// @param[in,out]  this  Pointer to Journal; must be already allocated
+/// @param[in]      start   The meeting to start from; may be NULL for an
+///       empty meeting. A meeting with no time (ts of 0) starts at the
+///       next event appended.
+/// @return  MPA_SUCCESS on success
+///          MPA_NULL_POINTER_ERR if the Journal pointer (this) is NULL.
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode Journal_restart(Journal* this, const Journal_Fold* start) {
+  MPA_RETURN_IF_NULL(this);
+
+  this->first = 0;
+  this->count = 0;
+  if (start != NULL) {
+    this->checkpoint = *start;
+  } else {
+    memset(&this->checkpoint, 0, sizeof(this->checkpoint));
+  }
+  this->tail = this->checkpoint;
+
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Folds one entry into a meeting. The rules mirror the Model's: attendance
+/// changes start a meeting that has attendees and stop one that has none,
+/// and the cost of each segment is rounded down on its own.
+/// @param[in,out]  fold  The meeting to fold the entry into
+/// @param[in]      entry  The entry
+/// @param[out]     closed  The segment that the entry ended, if any; may
+///       be NULL.
+/// @param[out]     didClose  Whether the entry ended a segment; may be NULL.
+/// @return  MPA_SUCCESS on success
+///          MPA_INVALID_INPUT_ERR if the entry is not valid.
+///          MPA_OVERFLOW_ERR if folding the entry would cause an integer
+///          overflow. The meeting is left unchanged.
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode Journal_foldEntry(Journal_Fold* fold, const Journal_Entry* entry, Journal_Segment* closed, bool* didClose) {
+  MPA_RETURN_IF_NULL(fold);
+  MPA_RETURN_IF_NULL(entry);
+  MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
+
+  if (entry->type >= LAST_JOURNAL_EVENT) { return MPA_INVALID_INPUT_ERR; }
+
+  Journal_Fold next = *fold;
+  next.ts += entry->dt;
+  if (entry->type == JOURNAL_EVENT_GAP) next.ts += entry->value;
+
+  // Attendance changes and pauses end the running segment. (A reset
+  // discards it instead.)
+  Journal_Segment segment = { 0 };
+  bool endsSegment = fold->running && ( (entry->type == JOURNAL_EVENT_ADJUST) || (entry->type == JOURNAL_EVENT_PAUSE) );
+  if (endsSegment) {
+    segment.startTS = fold->segmentStartTS;
+    segment.secs = (next.ts > fold->segmentStartTS) ? (uint32_t)(next.ts - fold->segmentStartTS) : 0;
+    segment.numAttendees = fold->numAttendees;
+    segment.totalMilliHourly = fold->totalMilliHourly;
+    segment.milliCost = (uint64_t)fold->totalMilliHourly * segment.secs / 3600;
+    if ( (mpaRet = u64add_u64_u64(&next.milliCost, fold->milliCost, segment.milliCost)) != MPA_SUCCESS) return mpaRet;
+  }
+
+  switch (entry->type) {
+    case JOURNAL_EVENT_ADJUST: {
+      int32_t salaryIncr = 0;
+      if ( (mpaRet = u16add_u16_s16(&next.numAttendees, fold->numAttendees, entry->count)) != MPA_SUCCESS) return mpaRet;
+      if ( (mpaRet = s32mult_s32_s32(&salaryIncr, (int32_t)entry->value, entry->count)) != MPA_SUCCESS) return mpaRet;
+      if ( (mpaRet = u32add_u32_s32(&next.totalMilliHourly, fold->totalMilliHourly, salaryIncr)) != MPA_SUCCESS) return mpaRet;
+      next.running = (next.numAttendees > 0);
+      next.segmentStartTS = next.ts;
+      break;
+    }
+    case JOURNAL_EVENT_PAUSE: {
+      next.running = false;
+      break;
+    }
+    case JOURNAL_EVENT_RESUME: {
+      if (!fold->running) {
+        next.running = true;
+        next.segmentStartTS = next.ts;
+      }
+      break;
+    }
+    case JOURNAL_EVENT_RESET: {
+      time_t ts = next.ts;
+      memset(&next, 0, sizeof(next));
+      next.ts = ts;
+      break;
+    }
+    default: break;
+  }
+
+  *fold = next;
+  if (didClose != NULL) *didClose = endsSegment;
+  if ( (closed != NULL) && endsSegment ) *closed = segment;
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Makes room for entries by folding the oldest ones into the checkpoint,
+/// a batch at a time. This doesn't change the meeting, only how much of it
+/// can still be broken down. Either enough batches are folded or none are.
+/// @param[in,out]  this  Pointer to Journal; must be already allocated
+/// @param[in]      needed   Number of free entries needed; at most the
+///       capacity.
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode Journal_makeRoom(Journal* this, const size_t needed) {
+  MPA_RETURN_IF_NULL(this);
+  MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
+
+  if (needed > this->capacity) { return MPA_INVALID_INPUT_ERR; }
+  if (this->capacity - this->count >= needed) { return MPA_SUCCESS; }
+
+  size_t toFold = needed - (this->capacity - this->count);
+  if (toFold < JOURNAL_FOLD_BATCH) toFold = JOURNAL_FOLD_BATCH;
+  if (toFold > this->count) toFold = this->count;
+
+  Journal_Fold checkpoint = this->checkpoint;
+  for (size_t idx=0; idx<toFold; idx++) {
+    if ( (mpaRet = Journal_foldEntry(&checkpoint, JOURNAL_ENTRY(this, idx), NULL, NULL)) != MPA_SUCCESS) return mpaRet;
+  }
+
+  this->checkpoint = checkpoint;
+  this->first = (this->first + toFold) % this->capacity;
+  this->count -= toFold;
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Appends an entry, and folds it into the tail. There must be room for
+/// it. After a reset, there is nothing before it to keep.
+/// @param[in,out]  this  Pointer to Journal; must be already allocated
+/// @param[in]      entry  The entry
+/// @return  MPA_SUCCESS on success
+///          MPA_FULL_ERR if there is no room for the entry.
+///          MPA_OVERFLOW_ERR if the entry would cause an integer overflow
+///          (the Journal is unchanged).
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode Journal_push(Journal* this, const Journal_Entry* entry) {
+  MPA_RETURN_IF_NULL(this);
+  MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
+
+  if (this->count == this->capacity) { return MPA_FULL_ERR; }
+  if ( (mpaRet = Journal_foldEntry(&this->tail, entry, NULL, NULL)) != MPA_SUCCESS) return mpaRet;
+
+  if (entry->type == JOURNAL_EVENT_RESET) {
+    this->first = 0;
+    this->count = 0;
+    this->checkpoint = this->tail;
+    return MPA_SUCCESS;
+  }
+
+  *JOURNAL_ENTRY(this, this->count) = *entry;
+  this->count++;
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Appends an event to the Journal. Events are folded into the tail as
+/// they are appended, so the meeting as of the last event is always at
+/// hand.
+///
+/// JRB NOTE: Time since the last entry that doesn't fit in the event's
+/// entry goes into a gap entry before it, so an event takes at most
+/// JOURNAL_MAX_EVENT_ENTRIES entries. The entries are folded into a scratch
+/// copy of the tail first, and room is made for all of them before any is
+/// pushed; pushing them can then no longer fail. So either the whole event
+/// is appended, or the Journal is unchanged.
+/// @param[in,out]  this  Pointer to Journal; must be already allocated
+/// @param[in]      ts   Time of the event; must not be before the last one
+///       (if it is, the event is recorded at the time of the last one).
+/// @param[in]      type   The event
+/// @param[in]      count   Number of attendees that joined (positive) or
+///       left (negative); ADJUST only.
+/// @param[in]      milliHourly   Hourly rate of each of those attendees, in
+///       thousandths of currency units; ADJUST only.
+/// @return  MPA_SUCCESS on success
+///          MPA_NULL_POINTER_ERR if the Journal pointer (this) is NULL.
+///          MPA_INVALID_INPUT_ERR if the event type is not valid.
+///          MPA_OVERFLOW_ERR if the event would cause an integer overflow.
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode Journal_append(Journal* this, const time_t ts, const Journal_EventType type, const int16_t count, const uint32_t milliHourly) {
+  MPA_RETURN_IF_NULL(this);
+  MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
+
+  if ( (type == JOURNAL_EVENT_GAP) || (type >= LAST_JOURNAL_EVENT) ) { return MPA_INVALID_INPUT_ERR; }
+
+  // A Journal started without a time starts at its first event.
+  bool untimed = (this->count == 0) && (this->tail.ts == 0);
+  Journal_Fold trial = this->tail;
+  if (untimed) trial.ts = ts;
+
+  Journal_Entry entries[JOURNAL_MAX_EVENT_ENTRIES];
+  size_t numEntries = 0;
+  time_t dt = (ts > trial.ts) ? (ts - trial.ts) : 0;
+  if (dt > UINT16_MAX) {
+    if ((uint64_t)dt > MPA_MAX(uint32_t)) { return MPA_OVERFLOW_ERR; }
+    entries[numEntries++] = (Journal_Entry) { .dt = 0, .type = JOURNAL_EVENT_GAP, .count = 0, .value = (uint32_t)dt };
+    dt = 0;
+  }
+  bool isAdjust = (type == JOURNAL_EVENT_ADJUST);
+  entries[numEntries++] = (Journal_Entry) { .dt = (uint16_t)dt, .type = type, .count = isAdjust ? count : 0, .value = isAdjust ? milliHourly : 0 };
+
+  for (size_t idx=0; idx<numEntries; idx++) {
+    if ( (mpaRet = Journal_foldEntry(&trial, &entries[idx], NULL, NULL)) != MPA_SUCCESS) return mpaRet;
+  }
+
+  if (untimed) {
+    this->checkpoint.ts = ts;
+    this->tail.ts = ts;
+  }
+  if ( (mpaRet = Journal_makeRoom(this, numEntries)) != MPA_SUCCESS) return mpaRet;
+  for (size_t idx=0; idx<numEntries; idx++) {
+    if ( (mpaRet = Journal_push(this, &entries[idx])) != MPA_SUCCESS) return mpaRet;
+  }
+
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Gets the number of entries held.
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode Journal_count(const Journal* this, size_t* count) {
+  MPA_RETURN_IF_NULL(this);
+  MPA_RETURN_IF_NULL(count);
+  *count = this->count;
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Gets the meeting as of the newest entry (the tail). It is kept up to
+/// date as entries are appended, so it costs nothing to get.
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode Journal_getFold(const Journal* this, Journal_Fold* fold) {
+  MPA_RETURN_IF_NULL(this);
+  MPA_RETURN_IF_NULL(fold);
+  *fold = this->tail;
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Gets the meeting as of just before the oldest entry held.
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode Journal_getCheckpoint(const Journal* this, Journal_Fold* fold) {
+  MPA_RETURN_IF_NULL(this);
+  MPA_RETURN_IF_NULL(fold);
+  *fold = this->checkpoint;
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Rebuilds the meeting from the checkpoint and the entries held, rather
+/// than trusting the tail. This takes one step per entry held.
+/// @param[in,out]  this  Pointer to Journal; must be already allocated
+/// @param[out]     fold  The rebuilt meeting
+/// @return  MPA_SUCCESS on success
+///          MPA_NULL_POINTER_ERR if a pointer is NULL.
+///          MPA_OVERFLOW_ERR if an entry would cause an integer overflow.
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode Journal_replay(const Journal* this, Journal_Fold* fold) {
+  MPA_RETURN_IF_NULL(this);
+  MPA_RETURN_IF_NULL(fold);
+  MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
+
+  Journal_Fold replayed = this->checkpoint;
+  for (size_t idx=0; idx<this->count; idx++) {
+    if ( (mpaRet = Journal_foldEntry(&replayed, JOURNAL_ENTRY(this, idx), NULL, NULL)) != MPA_SUCCESS) return mpaRet;
+  }
+
+  *fold = replayed;
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Breaks the meeting down into the segments held in the Journal (those
+/// after the checkpoint), oldest first. If the meeting is running, the
+/// last segment is the current one, up to the given time. The checkpoint's
+/// cost plus the cost of every segment is the cost of the meeting.
+/// @param[in,out]  this  Pointer to Journal; must be already allocated
+/// @param[in]      now   End of the current segment
+/// @param[in]      handler   Function given each segment
+/// @param[in]      context   Passed on to the handler
+/// @return  MPA_SUCCESS on success
+///          MPA_NULL_POINTER_ERR if a pointer is NULL.
+///          MPA_OVERFLOW_ERR if an entry would cause an integer overflow.
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode Journal_forEachSegment(const Journal* this, const time_t now, const Journal_SegmentHandler handler, void* context) {
+  MPA_RETURN_IF_NULL(this);
+  MPA_RETURN_IF_NULL(handler);
+  MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
+
+  Journal_Fold fold = this->checkpoint;
+  Journal_Segment segment;
+  bool didClose = false;
+  for (size_t idx=0; idx<this->count; idx++) {
+    if ( (mpaRet = Journal_foldEntry(&fold, JOURNAL_ENTRY(this, idx), &segment, &didClose)) != MPA_SUCCESS) return mpaRet;
+    if (didClose && !handler(&segment, context)) return MPA_SUCCESS;
+  }
+
+  if (fold.running) {
+    uint64_t totalMilliCost = 0;
+    if ( (mpaRet = Journal_getMilliCost(&fold, now, &totalMilliCost)) != MPA_SUCCESS) return mpaRet;
+    segment = (Journal_Segment) {
+      .startTS = fold.segmentStartTS,
+      .secs = (now > fold.segmentStartTS) ? (uint32_t)(now - fold.segmentStartTS) : 0,
+      .numAttendees = fold.numAttendees,
+      .totalMilliHourly = fold.totalMilliHourly,
+      .milliCost = totalMilliCost - fold.milliCost
+    };
+    handler(&segment, context);
+  }
+
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Gets the cost of a meeting at a given time: its completed segments,
+/// plus the running one up to then. The rate and the seconds at that rate
+/// are both 32-bit, so their product is made with one widening multiply
+/// and can't overflow; only the sum is checked.
+/// @param[in]      fold  The meeting
+/// @param[in]      now   The time
+/// @param[out]     milliCost  The cost, in thousandths of currency units
+/// @return  MPA_SUCCESS on success
+///          MPA_NULL_POINTER_ERR if a pointer is NULL.
+///          MPA_OVERFLOW_ERR if the calculation would cause an integer
+///          overflow.
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode Journal_getMilliCost(const Journal_Fold* fold, const time_t now, uint64_t* milliCost) {
+  MPA_RETURN_IF_NULL(fold);
+  MPA_RETURN_IF_NULL(milliCost);
+  MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
+
+  uint64_t total = fold->milliCost;
+  if ( fold->running && (now > fold->segmentStartTS) ) {
+    uint64_t segmentMilliCost = (uint64_t)fold->totalMilliHourly * (uint32_t)(now - fold->segmentStartTS) / 3600;
+    if ( (mpaRet = u64add_u64_u64(&total, total, segmentMilliCost)) != MPA_SUCCESS) return mpaRet;
+  }
+
+  *milliCost = total;
+  return MPA_SUCCESS;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <pebble.h>
+#include "../libs/magpebapp.h"
+
+
+// Most entries that one event can take (see Journal_append)
+#define JOURNAL_MAX_EVENT_ENTRIES 2
+
+
+// Journal event types
+typedef enum Journal_EventType {
+  JOURNAL_EVENT_GAP = 0,      ///< no change; only carries time that doesn't fit in the next entry
+  JOURNAL_EVENT_ADJUST,       ///< attendees joined (count > 0) or left (count < 0) at a rate
+  JOURNAL_EVENT_PAUSE,
+  JOURNAL_EVENT_RESUME,
+  JOURNAL_EVENT_RESET,
+
+  LAST_JOURNAL_EVENT
+} Journal_EventType;
+
+
+// One journal entry. Timestamps are relative to the previous entry, so an
+// entry is 9 bytes, whatever the meeting's length.
+typedef struct __attribute__((__packed__)) Journal_Entry {
+  uint16_t dt;                ///< seconds since the previous entry
+  uint8_t  type;              ///< Journal_EventType
+  int16_t  count;             ///< attendees joined or left (ADJUST only)
+  uint32_t value;             ///< ADJUST: hourly rate of each of those attendees; GAP: seconds passed
+} Journal_Entry;
+
+
+// The meeting as of some entry: every entry up to it, folded together.
+typedef struct Journal_Fold {
+  time_t   ts;                ///< time of the last entry folded in
+  uint16_t numAttendees;
+  uint32_t totalMilliHourly;
+  bool     running;
+  time_t   segmentStartTS;    ///< start of the current segment (if running)
+  uint64_t milliCost;         ///< cost of every completed segment, in thousandths
+} Journal_Fold;
+
+
+// A stretch of the meeting spent running at one rate
+typedef struct Journal_Segment {
+  time_t   startTS;
+  uint32_t secs;
+  uint16_t numAttendees;
+  uint32_t totalMilliHourly;
+  uint64_t milliCost;         ///< cost of this segment alone, in thousandths
+} Journal_Segment;
+
+// Journal_SegmentHandler is a pointer to a function that is given each
+// segment in turn; it returns false to stop the iteration.
+typedef bool (*Journal_SegmentHandler)(const Journal_Segment*, void*);
+
+
+// Journal struct typedef
+typedef struct Journal Journal;
+
+
+Journal* Journal_create(size_t capacity, const Journal_Fold* start);
+MagPebApp_ErrCode Journal_destroy(Journal* this);
+
+MagPebApp_ErrCode Journal_restart(Journal* this, const Journal_Fold*);
+MagPebApp_ErrCode Journal_append(Journal* this, const time_t, const Journal_EventType, const int16_t, const uint32_t);
+
+MagPebApp_ErrCode Journal_count(const Journal* this, size_t*);
+MagPebApp_ErrCode Journal_getFold(const Journal* this, Journal_Fold*);
+MagPebApp_ErrCode Journal_getCheckpoint(const Journal* this, Journal_Fold*);
+MagPebApp_ErrCode Journal_replay(const Journal* this, Journal_Fold*);
+MagPebApp_ErrCode Journal_forEachSegment(const Journal* this, const time_t, const Journal_SegmentHandler, void*);
+
+MagPebApp_ErrCode Journal_getMilliCost(const Journal_Fold*, const time_t, uint64_t*);
@@ -0,0 +1,18 @@
+#include <pebble.h>
+#include "Journal.h"
+
+
+struct Journal {
+  size_t         capacity;    ///< number of entries the journal can hold
+  size_t         first;       ///< index of the oldest entry
+  size_t         count;       ///< number of entries held
+  Journal_Entry* entries;     ///< storage for all entries (capacity entries)
+  Journal_Fold   checkpoint;  ///< the meeting as of just before the oldest entry
+  Journal_Fold   tail;        ///< the meeting as of the newest entry
+};
+
+
+MagPebApp_ErrCode Journal_init(Journal* this, size_t, const Journal_Fold*);
+MagPebApp_ErrCode Journal_makeRoom(Journal* this, const size_t);
+MagPebApp_ErrCode Journal_push(Journal* this, const Journal_Entry*);
+MagPebApp_ErrCode Journal_foldEntry(Journal_Fold*, const Journal_Entry*, Journal_Segment*, bool*);
@@ -9,6 +9,21 @@
 #include "../misc.h"
 
 
+// Number of journal entries the Model keeps. Older entries are folded into
+// the journal's checkpoint, so this bounds replay, not the meeting.
+#define MODEL_JOURNAL_CAPACITY 32
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Default clock source: the watch's real-time clock.
+/////////////////////////////////////////////////////////////////////////////
+static time_t Model_systemClock(uint16_t* ms) {
+  time_t now = 0;
+  uint16_t nowMs = 0;
+  time_ms(&now, &nowMs);
+  if (ms != NULL) *ms = nowMs;
+  return now;
+}
 
 
 /////////////////////////////////////////////////////////////////////////////
@@ -21,7 +36,7 @@ Model* Model_create() {
   Model* newModel = malloc(sizeof(*newModel));
   if ( (mpaRet = Model_init(newModel)) != MPA_SUCCESS) {
     APP_LOG(APP_LOG_LEVEL_ERROR, "Could not initialize: %s", MagPebApp_getErrMsg(mpaRet));
-    Model_destroy(newModel);  newModel = NULL;
+    newModel = NULL;
   }
 
   return newModel;
@@ -38,6 +53,7 @@ MagPebApp_ErrCode Model_destroy(Model* this) {
 
   // Free memory for data members
   if (this->currencySymbol != NULL)   { free(this->currencySymbol);   this->currencySymbol = NULL; }
+  if (this->journal != NULL)          { Journal_destroy(this->journal);  this->journal = NULL; }
 
   free(this); this = NULL;
   return MPA_SUCCESS;
@@ -54,7 +70,14 @@ MagPebApp_ErrCode Model_init(Model* this) {
   MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
 
   // Initialize/allocate data members
+  this->clock = Model_systemClock;
   this->currencySymbol = NULL;
+  this->defaultMilliHourly = 0;
+  this->numAttendees = 0;
+  this->totalMeetingMilliCost = 0;
+  this->status = MODEL_STATE_NO_ATTENDEES;
+  memset(this->generations, 0, sizeof(this->generations));
+  if ( (this->journal = Journal_create(MODEL_JOURNAL_CAPACITY, NULL)) == NULL) { goto freemem; }
   if ( (mpaRet = Model_reset(this)) != MPA_SUCCESS) { goto freemem; }
 
   // Determine locale
@@ -99,15 +122,50 @@ MagPebApp_ErrCode Model_reset(Model* this) {
   MPA_RETURN_IF_NULL(this);
   MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
 
-  this->numAttendees = 0;
-  this->totalMilliHourly = 0;
-  this->lastRateChangeTS = 0;
-  this->lastRateMilliCost = 0;
-  this->currentRateMilliCost = 0;
-  this->totalMeetingMilliCost = 0;
-  this->status = MODEL_STATE_NO_ATTENDEES;
+  if ( (mpaRet = Journal_append(this->journal, this->clock(NULL), JOURNAL_EVENT_RESET, 0, 0)) != MPA_SUCCESS) return mpaRet;
 
-  return mpaRet;
+  Journal_Fold tail;
+  Journal_getFold(this->journal, &tail);
+  this->meetingStartTS = 0;
+  this->runSecs = 0;
+  this->peakAttendees = 0;
+  Model_setStatus(this, MODEL_STATE_NO_ATTENDEES);
+
+  return Model_applyFold(this, &tail);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Replaces the Model's source of the current time. Every timestamp the
+/// Model records or compares against comes from this clock, so a
+/// simulated clock can replay hours of meeting time in moments.
+/// @param[in,out]  this  Pointer to Model; must be already allocated
+/// @param[in]      clock   The new clock, or NULL to restore the watch's
+///       real-time clock.
+/// @return  MPA_SUCCESS on success
+///          MPA_NULL_POINTER_ERR if the Model pointer (this) is NULL.
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode Model_setClock(Model* this, const Model_ClockHandler clock) {
+  MPA_RETURN_IF_NULL(this);
+  this->clock = (clock != NULL) ? clock : Model_systemClock;
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Gets the current time from the Model's clock.
+/// @param[in,out]  this  Pointer to Model; must be already allocated
+/// @param[out]     now   Pointer to the seconds variable
+/// @param[out]     ms    Pointer to the milliseconds variable; may be NULL
+/// @return  MPA_SUCCESS on success
+///          MPA_NULL_POINTER_ERR if the Model pointer (this) is NULL.
+///          MPA_NULL_POINTER_ERR if the now pointer is NULL.
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode Model_getTime(const Model* this, time_t* now, uint16_t* ms) {
+  MPA_RETURN_IF_NULL(this);
+  MPA_RETURN_IF_NULL(now);
+  *now = this->clock(ms);
+  return MPA_SUCCESS;
 }
 
 
@@ -152,6 +210,7 @@ MagPebApp_ErrCode Model_setCurrencySymbol(Model* this, const char* currSym) {
   this->currencySymbol = tmp;
 
   if (!strxcpy(this->currencySymbol, bufsize, currSym, "Currency symbol")) { return MPA_STRING_ERR; }
+  Model_touch(this, MODEL_FIELD_CURRENCY);
 
   return MPA_SUCCESS;
 }
@@ -172,6 +231,7 @@ MagPebApp_ErrCode Model_getDefaultMilliHourly(Model* this, uint32_t* defaultMill
 MagPebApp_ErrCode Model_setDefaultMilliHourly(Model* this, const uint32_t defaultMilliHourly) {
   MPA_RETURN_IF_NULL(this);
   APP_LOG(APP_LOG_LEVEL_DEBUG, "Setting default hourly rate to: %lu", defaultMilliHourly);
+  if (this->defaultMilliHourly != defaultMilliHourly) Model_touch(this, MODEL_FIELD_DEFAULT_RATE);
   this->defaultMilliHourly = defaultMilliHourly;
   return MPA_SUCCESS;
 }
@@ -200,35 +260,24 @@ MagPebApp_ErrCode Model_adjustAttendance(Model* this, const int16_t attenIncr, c
 
   uint32_t attenMilliHourly = (c_attenMilliHourly == 0) ? this->defaultMilliHourly : c_attenMilliHourly;
 
-  uint16_t numAttendees = this->numAttendees;
-  if ( (mpaRet = u16add_u16_s16(&numAttendees, numAttendees, attenIncr)) != MPA_SUCCESS) return mpaRet;
-
-  int32_t salaryIncr = 0;
-  if ( (mpaRet = s32mult_s32_s32(&salaryIncr, (int32_t)attenMilliHourly, attenIncr)) != MPA_SUCCESS) return mpaRet;
-
-  uint32_t totalMilliHourly = this->totalMilliHourly;
-  if ( (mpaRet = u32add_u32_s32(&totalMilliHourly, totalMilliHourly, salaryIncr)) != MPA_SUCCESS) return mpaRet;
+  time_t now = this->clock(NULL);
+  uint32_t runSecs = 0;
+  if ( (mpaRet = Model_accrueRunTime(this, now, &runSecs)) != MPA_SUCCESS) return mpaRet;
+  if ( (mpaRet = Journal_append(this->journal, now, JOURNAL_EVENT_ADJUST, attenIncr, attenMilliHourly)) != MPA_SUCCESS) return mpaRet;
 
-  if ( (mpaRet = Model_calculateCost(this)) != MPA_SUCCESS) return mpaRet;
-
-  uint32_t lastRateMilliCost = 0;
-  if ( (mpaRet = u32add_u32_s32(&lastRateMilliCost, this->lastRateMilliCost, this->currentRateMilliCost)) != MPA_SUCCESS) return mpaRet;
-
-  this->numAttendees = numAttendees;
-  this->totalMilliHourly = totalMilliHourly;
-  this->lastRateChangeTS = time(NULL);
-  this->lastRateMilliCost = lastRateMilliCost;
-  this->currentRateMilliCost = 0;
-  this->totalMeetingMilliCost = this->lastRateMilliCost;
+  Journal_Fold tail;
+  Journal_getFold(this->journal, &tail);
+  this->runSecs = runSecs;
+  if (tail.numAttendees > this->peakAttendees) this->peakAttendees = tail.numAttendees;
 
-  if (this->numAttendees <= 0) {
-     if ( (mpaRet = Model_stopMeeting(this)) != MPA_SUCCESS) return mpaRet;
-     this->status = MODEL_STATE_NO_ATTENDEES;
+  if (tail.numAttendees == 0) {
+    Model_setStatus(this, MODEL_STATE_NO_ATTENDEES);
   } else {
-     if ( (mpaRet = Model_startMeeting(this)) != MPA_SUCCESS) return mpaRet;
+    Model_setStatus(this, MODEL_STATE_STARTED);
+    if (this->meetingStartTS == 0) this->meetingStartTS = tail.segmentStartTS;
   }
 
-  return mpaRet;
+  return Model_applyFold(this, &tail);
 }
 
 
@@ -242,11 +291,16 @@ MagPebApp_ErrCode Model_startMeeting(Model* this) {
   MPA_RETURN_IF_NULL(this);
   MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
 
-  this->status = MODEL_STATE_STARTED;
-  if (this->lastRateChangeTS == 0) this->lastRateChangeTS = time(NULL);
-  if ( (mpaRet = Model_calculateCost(this)) != MPA_SUCCESS) return mpaRet;
+  if (this->lastRateChangeTS == 0) {
+    if ( (mpaRet = Journal_append(this->journal, this->clock(NULL), JOURNAL_EVENT_RESUME, 0, 0)) != MPA_SUCCESS) return mpaRet;
+  }
 
-  return MPA_SUCCESS;
+  Journal_Fold tail;
+  Journal_getFold(this->journal, &tail);
+  Model_setStatus(this, MODEL_STATE_STARTED);
+  if (this->meetingStartTS == 0) this->meetingStartTS = tail.segmentStartTS;
+
+  return Model_applyFold(this, &tail);
 }
 
 
@@ -262,25 +316,116 @@ MagPebApp_ErrCode Model_stopMeeting(Model* this) {
   MPA_RETURN_IF_NULL(this);
   MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
 
-  if ( (mpaRet = Model_calculateCost(this)) != MPA_SUCCESS) return mpaRet;
+  time_t now = this->clock(NULL);
+  uint32_t runSecs = 0;
+  if ( (mpaRet = Model_accrueRunTime(this, now, &runSecs)) != MPA_SUCCESS) return mpaRet;
+  if (this->lastRateChangeTS != 0) {
+    if ( (mpaRet = Journal_append(this->journal, now, JOURNAL_EVENT_PAUSE, 0, 0)) != MPA_SUCCESS) return mpaRet;
+  }
+
+  Journal_Fold tail;
+  Journal_getFold(this->journal, &tail);
+  this->runSecs = runSecs;
+  Model_setStatus(this, MODEL_STATE_STOPPED);
+
+  return Model_applyFold(this, &tail);
+}
 
-  uint32_t lastRateMilliCost = 0;
-  if ( (mpaRet = u32add_u32_u32(&lastRateMilliCost, this->lastRateMilliCost, this->currentRateMilliCost)) != MPA_SUCCESS) return mpaRet;
 
-  this->status = MODEL_STATE_STOPPED;
-  this->lastRateChangeTS = 0;
-  this->lastRateMilliCost = lastRateMilliCost;
+/////////////////////////////////////////////////////////////////////////////
+/// Works out the seconds the meeting has run up to a given time: runSecs,
+/// plus the time since lastRateChangeTS if it is running. Must be called
+/// before lastRateChangeTS moves (or is cleared) while the meeting runs.
+/// @param[in,out]  this  Pointer to Model; must be already allocated
+/// @param[in]      now   The current time
+/// @param[out]     runSecs   The seconds run
+/// @return  MPA_SUCCESS on success
+///          MPA_NULL_POINTER_ERR if the Model pointer (this) is NULL.
+///          MPA_OVERFLOW_ERR if the meeting has run for too long.
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode Model_accrueRunTime(const Model* this, const time_t now, uint32_t* runSecs) {
+  MPA_RETURN_IF_NULL(this);
+  MPA_RETURN_IF_NULL(runSecs);
+  *runSecs = this->runSecs;
+  if ( (this->status != MODEL_STATE_STARTED) || (this->lastRateChangeTS == 0) || (now <= this->lastRateChangeTS) ) {
+    return MPA_SUCCESS;
+  }
+  return u32add_u32_u32(runSecs, this->runSecs, (uint32_t)(now - this->lastRateChangeTS));
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Copies the meeting's rate and frozen cost from a journal fold (normally
+/// its tail), and brings the running cost up to date.
+/// @param[in,out]  this  Pointer to Model; must be already allocated
+/// @param[in]      fold  The meeting as of the journal's last event
+/// @return  MPA_SUCCESS on success
+///          MPA_NULL_POINTER_ERR if a pointer is NULL.
+///          MPA_OVERFLOW_ERR if the necessary calculations would cause an
+///          integer overflow.
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode Model_applyFold(Model* this, const Journal_Fold* fold) {
+  MPA_RETURN_IF_NULL(this);
+  MPA_RETURN_IF_NULL(fold);
+
+  if (this->numAttendees != fold->numAttendees) Model_touch(this, MODEL_FIELD_ATTENDEES);
+  this->numAttendees = fold->numAttendees;
+  this->totalMilliHourly = fold->totalMilliHourly;
+  this->lastRateChangeTS = fold->running ? fold->segmentStartTS : 0;
+  this->lastRateMilliCost = fold->milliCost;
   this->currentRateMilliCost = 0;
-  this->totalMeetingMilliCost = this->lastRateMilliCost;
+  Model_setTotalMilliCost(this, this->lastRateMilliCost);
 
-  return mpaRet;
+  return Model_calculateCost(this);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Marks a field as changed by bumping its generation counter.
+/// @param[in,out]  this  Pointer to Model; must be already allocated
+/// @param[in]      field  The field that changed
+/////////////////////////////////////////////////////////////////////////////
+void Model_touch(Model* this, const Model_Field field) {
+  if ( (this == NULL) || (field >= LAST_MODEL_FIELD) ) return;
+  this->generations[field]++;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Sets the meeting status, marking it as changed if it differs.
+/// @param[in,out]  this  Pointer to Model; must be already allocated
+/// @param[in]      status  The new status
+/////////////////////////////////////////////////////////////////////////////
+void Model_setStatus(Model* this, const Model_State status) {
+  if (this == NULL) return;
+  if (this->status != status) Model_touch(this, MODEL_FIELD_STATUS);
+  this->status = status;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Sets the total meeting cost, marking the cost as changed only if the
+/// displayed value (hundredths of a currency unit) differs.
+/// @param[in,out]  this  Pointer to Model; must be already allocated
+/// @param[in]      totalMilliCost  The new total, in thousandths of
+///       currency units
+/////////////////////////////////////////////////////////////////////////////
+void Model_setTotalMilliCost(Model* this, const uint64_t totalMilliCost) {
+  if (this == NULL) return;
+  if ( (totalMilliCost / 10) != (this->totalMeetingMilliCost / 10) ) Model_touch(this, MODEL_FIELD_COST);
+  this->totalMeetingMilliCost = totalMilliCost;
 }
 
 
 /////////////////////////////////////////////////////////////////////////////
 /// Internal calculation routine to update the cost of a meeting that is in
 /// progress. To optimize memory for Pebble, this function restricts its
-/// math to integers.
+/// math to integers. Costs are accumulated in 64 bits, so a meeting of
+/// 10,000 attendees can run for several days without overflowing.
+///
+/// The cost is folded onto the journal's tail (the meeting as of its last
+/// event): the cost frozen there, plus the running segment up to now. So
+/// it is one calculation however many events the meeting had.
 /// @param[in,out]  this  Pointer to Model; must be already allocated
 /// @return  MPA_SUCCESS on success
 ///          MPA_NULL_POINTER_ERR if the Model pointer (this) is NULL.
@@ -291,26 +436,20 @@ MagPebApp_ErrCode Model_calculateCost(Model* this) {
   MPA_RETURN_IF_NULL(this);
   MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
 
-  if (this->lastRateChangeTS == 0) return mpaRet;
-  time_t currentTime = time(NULL);
-  uint32_t elapsedTimeAtRate = (currentTime - this->lastRateChangeTS);
-
+  Journal_Fold tail;
+  if ( (mpaRet = Journal_getFold(this->journal, &tail)) != MPA_SUCCESS) return mpaRet;
+  if (!tail.running) return mpaRet;
 
-  uint32_t currentRateMilliCost = 0;
-  if ( (mpaRet = u32mult_u32_u32(&currentRateMilliCost, this->totalMilliHourly, elapsedTimeAtRate)) != MPA_SUCCESS) return mpaRet;
-  currentRateMilliCost /= 3600;
+  // If the wall clock was set backwards, no negative time is billed.
+  uint64_t totalMeetingMilliCost = 0;
+  if ( (mpaRet = Journal_getMilliCost(&tail, this->clock(NULL), &totalMeetingMilliCost)) != MPA_SUCCESS) return mpaRet;
 
-  uint32_t totalMeetingMilliCost = 0;
-  if ( (mpaRet = u32add_u32_u32(&totalMeetingMilliCost, this->lastRateMilliCost, currentRateMilliCost)) != MPA_SUCCESS) return mpaRet;
+  this->currentRateMilliCost = totalMeetingMilliCost - tail.milliCost;
+  Model_setTotalMilliCost(this, totalMeetingMilliCost);
 
-  this->currentRateMilliCost = currentRateMilliCost;
-  this->totalMeetingMilliCost = totalMeetingMilliCost;
-
-  int32_t totalKiloSalary = this->totalMilliHourly * 208 / 100000;
-  s32RoundNear(&totalKiloSalary, totalKiloSalary, 10);
-  APP_LOG(APP_LOG_LEVEL_DEBUG, "Attendees: %u   Total Salary: %luK   Elapsed Time at Rate: %lu secs", this->numAttendees, totalKiloSalary, elapsedTimeAtRate);
-  APP_LOG(APP_LOG_LEVEL_DEBUG, "Cents/hr: %lu   Cents/min: %lu   Cents/sec: %lu", this->totalMilliHourly/10, this->totalMilliHourly/600, this->totalMilliHourly/36000);
-  APP_LOG(APP_LOG_LEVEL_DEBUG, "LastRateCost: %lu   CurrentRateCost: %lu", this->lastRateMilliCost, this->currentRateMilliCost);
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "Attendees: %u   Rate since: %ld", this->numAttendees, (long)tail.segmentStartTS);
+  // JRB NOTE: Pebble's printf doesn't do 64-bit integers, so only the low words are logged.
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "LastRateCost: %lu   CurrentRateCost: %lu", (unsigned long)this->lastRateMilliCost, (unsigned long)this->currentRateMilliCost);
 
   return mpaRet;
 }
@@ -329,34 +468,132 @@ MagPebApp_ErrCode Model_updateTime(Model* this, struct tm *tick_time, TimeUnits
 
 
 /////////////////////////////////////////////////////////////////////////////
-/// Calculates the latest meeting cost and provides a string describing the
-/// cost of the meeting formatted in the chosen currency.
+/// Works out the moment the formatted meeting cost (which shows whole
+/// hundredths of a currency unit) will next change, so the caller can
+/// sleep until then instead of polling every second.
+///
+/// The displayed value changes once the total reaches the next multiple
+/// of ten thousandths. Since the cost at the current rate after n seconds
+/// is floor(totalMilliHourly * n / 3600), the first second at which that
+/// happens is n = ceil(needed * 3600 / totalMilliHourly).
 /// @param[in,out]  this  Pointer to Model; must be already allocated
-/// @param[out]     fmtdCost   Pointer to a C-string; must be NULL on entry.
-///       <em>Ownership is transferred to the caller, and the caller
-///       is responsible for freeing this variable.</em>
+/// @param[out]     changeTS   Timestamp (in seconds) of the next visible
+///       change, or 0 if the cost is not currently changing (meeting not
+///       running or no hourly rate).
 /// @return  MPA_SUCCESS on success
 ///          MPA_NULL_POINTER_ERR if the Model pointer (this) is NULL.
-///          MPA_INVALID_INPUT_ERR if fmtdCost is not NULL.
-///          MPA_OUT_OF_MEMORY_ERR if memory could not be allocated.
-///          MPA_STRING_ERR if fmtdCost string could not be written correctly
+///          MPA_NULL_POINTER_ERR if the changeTS pointer is NULL.
+///          MPA_OVERFLOW_ERR if the necessary calculations would cause an
+///          integer overflow.
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode Model_getNextVisibleChange(const Model* this, time_t* changeTS) {
+  MPA_RETURN_IF_NULL(this);
+  MPA_RETURN_IF_NULL(changeTS);
+  MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
+
+  *changeTS = 0;
+  if ( (this->status != MODEL_STATE_STARTED) || (this->lastRateChangeTS == 0) || (this->totalMilliHourly == 0) ) {
+    return MPA_SUCCESS;
+  }
+
+  // Cost (in thousandths) at which the displayed hundredths next roll over
+  uint64_t nextVisibleMilliCost = 0;
+  if ( (mpaRet = u64add_u64_u64(&nextVisibleMilliCost, this->totalMeetingMilliCost - (this->totalMeetingMilliCost % 10), 10)) != MPA_SUCCESS) return mpaRet;
+
+  return Model_getCostReachedTS(this, nextVisibleMilliCost, changeTS);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Computes when the meeting cost reaches a given amount, at the current
+/// rate, without stepping through time: the cost at the current rate after
+/// n seconds is floor(totalMilliHourly * n / 3600), so the amount is first
+/// reached at n = ceil(needed * 3600 / totalMilliHourly).
+/// @param[in,out]  this  Pointer to Model; must be already allocated
+/// @param[in]      milliCost   The amount, in thousandths of currency units
+/// @param[out]     reachTS   Timestamp (in seconds) at which the cost
+///       reaches the amount. This is in the past if it already has. It is
+///       0 if the cost is not currently rising (meeting not running or no
+///       hourly rate).
+/// @return  MPA_SUCCESS on success
+///          MPA_NULL_POINTER_ERR if the Model pointer (this) is NULL.
+///          MPA_NULL_POINTER_ERR if the reachTS pointer is NULL.
+///          MPA_OVERFLOW_ERR if the necessary calculations would cause an
+///          integer overflow.
 /////////////////////////////////////////////////////////////////////////////
-MagPebApp_ErrCode Model_getFmtdMeetingCost(const Model* this, char** fmtdCost) {
+MagPebApp_ErrCode Model_getCostReachedTS(const Model* this, const uint64_t milliCost, time_t* reachTS) {
   MPA_RETURN_IF_NULL(this);
-  if (*fmtdCost != NULL) { return MPA_INVALID_INPUT_ERR; }
+  MPA_RETURN_IF_NULL(reachTS);
   MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
 
-  if ( (*fmtdCost = malloc(sizeof(**fmtdCost) * FMTD_COST_SZ)) == NULL) goto freemem;
+  *reachTS = 0;
+  if ( (this->status != MODEL_STATE_STARTED) || (this->lastRateChangeTS == 0) || (this->totalMilliHourly == 0) ) {
+    return MPA_SUCCESS;
+  }
+
+  if (milliCost <= this->lastRateMilliCost) {
+    *reachTS = this->lastRateChangeTS;
+    return MPA_SUCCESS;
+  }
+
+  uint64_t neededMilliCost = milliCost - this->lastRateMilliCost;
+  uint64_t neededRateSecs = 0;
+  if ( (mpaRet = u64mult_u64_u32(&neededRateSecs, neededMilliCost, 3600)) != MPA_SUCCESS) return mpaRet;
+  uint64_t secsAtRate = (neededRateSecs + this->totalMilliHourly - 1) / this->totalMilliHourly;
+
+  if (secsAtRate > MPA_MAX(int32_t)) return MPA_OVERFLOW_ERR;
+  *reachTS = this->lastRateChangeTS + (time_t)secsAtRate;
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Provides a string describing the cost of the meeting formatted in the
+/// chosen currency. No memory is allocated; the string is written into the
+/// caller's buffer.
+/// @param[in,out]  this  Pointer to Model; must be already allocated
+/// @param[out]     fmtdCost   Caller-owned buffer that will hold the
+///       formatted C-string. FMTD_COST_SZ bytes is always large enough.
+/// @param[in]      bufsize    Size of the fmtdCost buffer, in bytes
+/// @return  MPA_SUCCESS on success
+///          MPA_NULL_POINTER_ERR if the Model pointer (this) is NULL.
+///          MPA_NULL_POINTER_ERR if the fmtdCost pointer is NULL.
+///          MPA_STRING_ERR if fmtdCost string could not be written correctly
+///          MPA_OVERFLOW_ERR if the cost is too large to be displayed
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode Model_getFmtdMeetingCost(const Model* this, char* fmtdCost, size_t bufsize) {
+  MPA_RETURN_IF_NULL(this);
+  MPA_RETURN_IF_NULL(fmtdCost);
+
+  // JRB NOTE: Pebble's printf doesn't do 64-bit integers, so the whole
+  // currency units must fit in 32 bits to be displayed.
+  uint64_t wholeUnits = this->totalMeetingMilliCost / 1000;
+  if (wholeUnits > MPA_MAX(uint32_t)) { return MPA_OVERFLOW_ERR; }
+  uint32_t centUnits = (uint32_t)(this->totalMeetingMilliCost % 1000) / 10;
 
   long lret = 0;
-  if ( (lret = snprintf(*fmtdCost, FMTD_COST_SZ, "%s%lu.%02lu", this->currencySymbol, this->totalMeetingMilliCost/1000, (this->totalMeetingMilliCost%1000)/10)) < 0) mpaRet = MPA_STRING_ERR;
-  else if ((size_t)lret >= FMTD_COST_SZ) mpaRet = MPA_STRING_ERR;
+  if ( (lret = snprintf(fmtdCost, bufsize, "%s%lu.%02lu", this->currencySymbol, (unsigned long)wholeUnits, (unsigned long)centUnits)) < 0) return MPA_STRING_ERR;
+  else if ((size_t)lret >= bufsize) return MPA_STRING_ERR;
 
-  return mpaRet;
+  return MPA_SUCCESS;
+}
 
-freemem:
-  if ( (*fmtdCost) != NULL) { free(*fmtdCost);  (*fmtdCost) = NULL; }
-  return MPA_OUT_OF_MEMORY_ERR;
+
+/////////////////////////////////////////////////////////////////////////////
+/// Gets the cost of the meeting in the units that are displayed (hundredths
+/// of a currency unit), so views can tell whether the formatted cost would
+/// change without formatting it.
+/// @param[in,out]  this  Pointer to Model; must be already allocated
+/// @param[out]     centiCost   Pointer to the cost variable
+/// @return  MPA_SUCCESS on success
+///          MPA_NULL_POINTER_ERR if the Model pointer (this) is NULL.
+///          MPA_NULL_POINTER_ERR if the centiCost pointer is NULL.
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode Model_getCentiMeetingCost(const Model* this, uint64_t* centiCost) {
+  MPA_RETURN_IF_NULL(this);
+  MPA_RETURN_IF_NULL(centiCost);
+  *centiCost = this->totalMeetingMilliCost / 10;
+  return MPA_SUCCESS;
 }
 
 
@@ -391,3 +628,230 @@ MagPebApp_ErrCode Model_getStatus(const Model* this, Model_State* status) {
   return MPA_SUCCESS;
 }
 
+
+/////////////////////////////////////////////////////////////////////////////
+/// Reports which fields changed since an observer last looked, and brings
+/// the observer's generation counters up to date.
+/// @param[in,out]  this  Pointer to Model; must be already allocated
+/// @param[in,out]  seen   The observer's generation counters
+/// @param[out]     changed   Bitmask of fields (MODEL_FIELD_BIT) whose
+///       values changed since the counters in seen were recorded
+/// @return  MPA_SUCCESS on success
+///          MPA_NULL_POINTER_ERR if the Model pointer (this) is NULL.
+///          MPA_NULL_POINTER_ERR if the seen or changed pointer is NULL.
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode Model_getChanges(const Model* this, Model_Generations* seen, Model_FieldMask* changed) {
+  MPA_RETURN_IF_NULL(this);
+  MPA_RETURN_IF_NULL(seen);
+  MPA_RETURN_IF_NULL(changed);
+
+  *changed = 0;
+  for (int idx=0; idx<LAST_MODEL_FIELD; idx++) {
+    if (seen->field[idx] != this->generations[idx]) {
+      *changed |= MODEL_FIELD_BIT(idx);
+      seen->field[idx] = this->generations[idx];
+    }
+  }
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Writes an unsigned integer of the given width in little-endian order.
+/////////////////////////////////////////////////////////////////////////////
+static uint8_t* Model_packUint(uint8_t* dest, uint64_t value, const uint8_t width) {
+  for (uint8_t idx=0; idx<width; idx++) {
+    dest[idx] = (uint8_t)(value & 0xFF);
+    value >>= 8;
+  }
+  return dest + width;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Packs the state of the meeting into a compact, versioned binary record,
+/// so it can be sent without formatting any strings. All integers are
+/// little-endian:
+///
+///   offset  size  field
+///        0     1  version (MODEL_SNAPSHOT_VER)
+///        1     1  status (Model_State)
+///        2     2  numAttendees
+///        4     4  totalMilliHourly
+///        8     4  lastRateChangeTS (0 if the meeting is not running)
+///       12     8  lastRateMilliCost
+///       20     8  totalMeetingMilliCost, as of snapshotTS
+///       28     4  snapshotTS
+///
+/// With the rate and lastRateChangeTS, the receiver can keep the cost
+/// running on its own without further messages.
+/// @param[in,out]  this  Pointer to Model; must be already allocated
+/// @param[out]     buffer   Caller-owned buffer to hold the snapshot
+/// @param[in]      bufsize  Size of the buffer, in bytes; must be at least
+///       MODEL_SNAPSHOT_SZ
+/// @return  MPA_SUCCESS on success
+///          MPA_NULL_POINTER_ERR if the Model pointer (this) is NULL.
+///          MPA_NULL_POINTER_ERR if the buffer pointer is NULL.
+///          MPA_INVALID_INPUT_ERR if the buffer is too small.
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode Model_packSnapshot(const Model* this, uint8_t* buffer, size_t bufsize) {
+  MPA_RETURN_IF_NULL(this);
+  MPA_RETURN_IF_NULL(buffer);
+  if (bufsize < MODEL_SNAPSHOT_SZ) { return MPA_INVALID_INPUT_ERR; }
+
+  uint8_t* cursor = buffer;
+  cursor = Model_packUint(cursor, MODEL_SNAPSHOT_VER, 1);
+  cursor = Model_packUint(cursor, (uint8_t)this->status, 1);
+  cursor = Model_packUint(cursor, this->numAttendees, 2);
+  cursor = Model_packUint(cursor, this->totalMilliHourly, 4);
+  cursor = Model_packUint(cursor, (uint32_t)this->lastRateChangeTS, 4);
+  cursor = Model_packUint(cursor, this->lastRateMilliCost, 8);
+  cursor = Model_packUint(cursor, this->totalMeetingMilliCost, 8);
+  cursor = Model_packUint(cursor, (uint32_t)this->clock(NULL), 4);
+
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Captures the meeting state that the clock can't reproduce. The
+/// checkpoint only changes on state transitions (attendance changes,
+/// starting, stopping, resetting), not as the meeting runs.
+/// @param[in,out]  this  Pointer to Model; must be already allocated
+/// @param[out]     checkpoint   Caller-owned checkpoint to fill in
+/// @return  MPA_SUCCESS on success
+///          MPA_NULL_POINTER_ERR if the Model pointer (this) is NULL.
+///          MPA_NULL_POINTER_ERR if the checkpoint pointer is NULL.
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode Model_getCheckpoint(const Model* this, Model_Checkpoint* checkpoint) {
+  MPA_RETURN_IF_NULL(this);
+  MPA_RETURN_IF_NULL(checkpoint);
+
+  memset(checkpoint, 0, sizeof(*checkpoint));
+  checkpoint->checkpointVer = MODEL_CHECKPOINT_VER;
+  checkpoint->status = (uint8_t)this->status;
+  checkpoint->numAttendees = this->numAttendees;
+  checkpoint->totalMilliHourly = this->totalMilliHourly;
+  checkpoint->lastRateChangeTS = (uint32_t)this->lastRateChangeTS;
+  checkpoint->lastRateMilliCost = this->lastRateMilliCost;
+  checkpoint->meetingStartTS = (uint32_t)this->meetingStartTS;
+  checkpoint->runSecs = this->runSecs;
+  checkpoint->peakAttendees = this->peakAttendees;
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Puts the meeting back into the state captured by Model_getCheckpoint.
+/// The journal starts over from the checkpoint, with the cost so far folded
+/// into it, and the meeting is rebuilt by replaying the journal from there;
+/// replay only covers the events since the checkpoint, which just after a
+/// restore is none, whatever the meeting's history. A running meeting is
+/// then brought up to date with a single cost calculation for all the time
+/// that passed since the checkpoint, however long.
+/// @param[in,out]  this  Pointer to Model; must be already allocated
+/// @param[in]      checkpoint   The checkpoint to restore
+/// @return  MPA_SUCCESS on success
+///          MPA_NULL_POINTER_ERR if the Model pointer (this) is NULL.
+///          MPA_NULL_POINTER_ERR if the checkpoint pointer is NULL.
+///          MPA_INVALID_INPUT_ERR if the checkpoint is of an unknown
+///          version or is inconsistent (the Model is unchanged).
+///          MPA_OVERFLOW_ERR if the necessary calculations would cause an
+///          integer overflow.
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode Model_restoreCheckpoint(Model* this, const Model_Checkpoint* checkpoint) {
+  MPA_RETURN_IF_NULL(this);
+  MPA_RETURN_IF_NULL(checkpoint);
+
+  if ( (checkpoint->checkpointVer != MODEL_CHECKPOINT_VER) && (checkpoint->checkpointVer != 1) ) { return MPA_INVALID_INPUT_ERR; }
+  if (checkpoint->status >= LAST_MODEL_STATE) { return MPA_INVALID_INPUT_ERR; }
+  if ( (checkpoint->status == MODEL_STATE_STARTED) && (checkpoint->lastRateChangeTS == 0) ) { return MPA_INVALID_INPUT_ERR; }
+  MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
+
+  Journal_Fold start = {
+    .ts = (time_t)checkpoint->lastRateChangeTS,
+    .numAttendees = checkpoint->numAttendees,
+    .totalMilliHourly = checkpoint->totalMilliHourly,
+    .running = (checkpoint->status == MODEL_STATE_STARTED),
+    .segmentStartTS = (time_t)checkpoint->lastRateChangeTS,
+    .milliCost = checkpoint->lastRateMilliCost
+  };
+  Journal_Fold replayed;
+  if ( (mpaRet = Journal_restart(this->journal, &start)) != MPA_SUCCESS) return mpaRet;
+  if ( (mpaRet = Journal_replay(this->journal, &replayed)) != MPA_SUCCESS) return mpaRet;
+
+  if (checkpoint->checkpointVer == 1) {
+    // JRB NOTE: Version 1 didn't keep the meeting's start, run time or
+    // peak attendance. The current segment is the best that can be done.
+    this->meetingStartTS = (time_t)checkpoint->lastRateChangeTS;
+    this->runSecs = 0;
+    this->peakAttendees = checkpoint->numAttendees;
+  } else {
+    this->meetingStartTS = (time_t)checkpoint->meetingStartTS;
+    this->runSecs = checkpoint->runSecs;
+    this->peakAttendees = checkpoint->peakAttendees;
+  }
+  Model_setStatus(this, (Model_State)checkpoint->status);
+
+  return Model_applyFold(this, &replayed);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Sums up the meeting as of now: when it started, how long it ran, its
+/// peak attendance and its total cost.
+/// @param[in,out]  this  Pointer to Model; must be already allocated
+/// @param[out]     summary   Caller-owned summary to fill in
+/// @return  MPA_SUCCESS on success
+///          MPA_NULL_POINTER_ERR if the Model pointer (this) is NULL.
+///          MPA_NULL_POINTER_ERR if the summary pointer is NULL.
+///          MPA_OVERFLOW_ERR if the necessary calculations would cause an
+///          integer overflow.
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode Model_getSummary(Model* this, Model_Summary* summary) {
+  MPA_RETURN_IF_NULL(this);
+  MPA_RETURN_IF_NULL(summary);
+  MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
+
+  if ( (mpaRet = Model_calculateCost(this)) != MPA_SUCCESS) return mpaRet;
+
+  uint32_t durationSecs = 0;
+  if ( (mpaRet = Model_accrueRunTime(this, this->clock(NULL), &durationSecs)) != MPA_SUCCESS) return mpaRet;
+
+  summary->startTS = this->meetingStartTS;
+  summary->durationSecs = durationSecs;
+  summary->peakAttendees = this->peakAttendees;
+  summary->milliCost = this->totalMeetingMilliCost;
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Breaks the meeting's cost down exactly, by the stretches it spent
+/// running at one rate, oldest first. Only the stretches since the
+/// journal's checkpoint are kept separately; the cost of those before it
+/// is given as one sum. That sum plus the cost of every stretch is the
+/// meeting's cost as of now.
+/// @param[in,out]  this  Pointer to Model; must be already allocated
+/// @param[out]     foldedMilliCost   Cost of the stretches before the
+///       journal's checkpoint, in thousandths; may be NULL.
+/// @param[in]      handler   Function given each stretch; it returns false
+///       to stop the iteration
+/// @param[in]      context   Passed on to the handler
+/// @return  MPA_SUCCESS on success
+///          MPA_NULL_POINTER_ERR if the Model pointer (this) is NULL.
+///          MPA_NULL_POINTER_ERR if the handler is NULL.
+///          MPA_OVERFLOW_ERR if the necessary calculations would cause an
+///          integer overflow.
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode Model_getBreakdown(const Model* this, uint64_t* foldedMilliCost, const Journal_SegmentHandler handler, void* context) {
+  MPA_RETURN_IF_NULL(this);
+  MPA_RETURN_IF_NULL(handler);
+
+  if (foldedMilliCost != NULL) {
+    Journal_Fold checkpoint;
+    Journal_getCheckpoint(this->journal, &checkpoint);
+    *foldedMilliCost = checkpoint.milliCost;
+  }
+  return Journal_forEachSegment(this->journal, this->clock(NULL), handler, context);
+}
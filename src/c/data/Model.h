@@ -2,10 +2,20 @@
 
 #include <pebble.h>
 #include "../libs/magpebapp.h"
+#include "Journal.h"
 
 
 #define FMTD_COST_SZ 16
 
+// Binary Model snapshot (see Model_packSnapshot)
+#define MODEL_SNAPSHOT_VER 1
+#define MODEL_SNAPSHOT_SZ  32
+
+// Model checkpoint layout version (see Model_getCheckpoint). Version 1
+// checkpoints end before meetingStartTS; they are still restored.
+#define MODEL_CHECKPOINT_VER 2
+#define MODEL_CHECKPOINT_V1_SZ 20
+
 
 // State definitions
 typedef enum Model_State {
@@ -18,6 +28,59 @@ typedef enum Model_State {
 
 
 
+// Field definitions, for change notification
+typedef enum Model_Field {
+  MODEL_FIELD_COST = 0,       ///< displayed meeting cost (changes when the hundredths shown change)
+  MODEL_FIELD_ATTENDEES,
+  MODEL_FIELD_STATUS,
+  MODEL_FIELD_CURRENCY,
+  MODEL_FIELD_DEFAULT_RATE,
+
+  LAST_MODEL_FIELD
+} Model_Field;
+
+// Bitmask of Model_Field values
+typedef uint8_t Model_FieldMask;
+#define MODEL_FIELD_BIT(F)  ((Model_FieldMask)(1 << (F)))
+#define MODEL_FIELDS_ALL    ((Model_FieldMask)((1 << LAST_MODEL_FIELD) - 1))
+
+// Generation counters for each field, as last seen by an observer
+typedef struct Model_Generations {
+  uint16_t field[LAST_MODEL_FIELD];
+} Model_Generations;
+
+
+// The meeting state that the clock can't reproduce: everything needed to
+// rebuild the running cost with one calculation. It only changes on state
+// transitions, so it can be persisted then and restored on the next launch.
+typedef struct __attribute__((__packed__)) Model_Checkpoint {
+  uint8_t  checkpointVer;       ///< MODEL_CHECKPOINT_VER
+  uint8_t  status;              ///< Model_State
+  uint16_t numAttendees;
+  uint32_t totalMilliHourly;
+  uint32_t lastRateChangeTS;    ///< 0 unless the meeting is running
+  uint64_t lastRateMilliCost;
+  uint32_t meetingStartTS;      ///< 0 unless the meeting has started
+  uint32_t runSecs;             ///< seconds run before lastRateChangeTS
+  uint16_t peakAttendees;
+} Model_Checkpoint;
+
+
+// A meeting, summed up
+typedef struct Model_Summary {
+  time_t   startTS;             ///< when the meeting first started; 0 if it never did
+  uint32_t durationSecs;        ///< time spent running (pauses are not counted)
+  uint16_t peakAttendees;
+  uint64_t milliCost;           ///< total cost, in thousandths of currency units
+} Model_Summary;
+
+
+// Model_ClockHandler is a pointer to a function that returns the current
+// time in seconds, and writes the milliseconds part to its parameter if
+// that parameter is not NULL.
+typedef time_t (*Model_ClockHandler)(uint16_t*);
+
+
 // Model struct typedef
 typedef struct Model Model;
 
@@ -26,17 +89,28 @@ Model* Model_create();
 MagPebApp_ErrCode Model_destroy(Model* this);
 
 MagPebApp_ErrCode Model_reset(Model* this);
+MagPebApp_ErrCode Model_setClock(Model* this, const Model_ClockHandler);
+MagPebApp_ErrCode Model_getTime(const Model* this, time_t*, uint16_t*);
 MagPebApp_ErrCode Model_setCurrencySymbol(Model* this, const char*);
 MagPebApp_ErrCode Model_setDefaultMilliHourly(Model* this, const uint32_t);
 MagPebApp_ErrCode Model_adjustAttendance(Model* this, const int16_t, const uint32_t);
 MagPebApp_ErrCode Model_startMeeting(Model* this);
 MagPebApp_ErrCode Model_stopMeeting(Model* this);
 
-MagPebApp_ErrCode Model_getFmtdMeetingCost(const Model* this, char**);
+MagPebApp_ErrCode Model_getFmtdMeetingCost(const Model* this, char*, size_t);
+MagPebApp_ErrCode Model_getCentiMeetingCost(const Model* this, uint64_t*);
 MagPebApp_ErrCode Model_getNumAttendees(const Model* this, uint16_t*);
 
 MagPebApp_ErrCode Model_getCurrencySymbol(const Model* this, char**);
 MagPebApp_ErrCode Model_getDefaultMilliHourly(Model* this, uint32_t*);
 MagPebApp_ErrCode Model_getStatus(const Model* this, Model_State*);
+MagPebApp_ErrCode Model_getChanges(const Model* this, Model_Generations*, Model_FieldMask*);
+MagPebApp_ErrCode Model_packSnapshot(const Model* this, uint8_t*, size_t);
+MagPebApp_ErrCode Model_getCheckpoint(const Model* this, Model_Checkpoint*);
+MagPebApp_ErrCode Model_restoreCheckpoint(Model* this, const Model_Checkpoint*);
+MagPebApp_ErrCode Model_getSummary(Model* this, Model_Summary*);
+MagPebApp_ErrCode Model_getBreakdown(const Model* this, uint64_t*, const Journal_SegmentHandler, void*);
 
 MagPebApp_ErrCode Model_updateTime(Model* this, struct tm *tick_time, TimeUnits units_changed);
+MagPebApp_ErrCode Model_getNextVisibleChange(const Model* this, time_t*);
+MagPebApp_ErrCode Model_getCostReachedTS(const Model* this, const uint64_t, time_t*);
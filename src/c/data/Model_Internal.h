@@ -4,18 +4,29 @@
 
 struct Model {
   // Data members
+  Model_ClockHandler clock;        ///< source of the current time; time_ms() unless overridden (eg. by a simulator)
   char*    currencySymbol;         ///< eg. "$" for dollar, "¥" for yen, "£" for pounds (these are multi-byte character strings)
   uint32_t defaultMilliHourly;     ///< default hourly rate of an attendee (in thousandths of currency units, eg. 50000 = $50/hr)
+  Journal* journal;                ///< the meeting's events since its checkpoint; the fields below, up to lastRateMilliCost, are copied from its tail
   uint16_t numAttendees;           ///< number of persons currently attending the meeting
   uint32_t totalMilliHourly;       ///< total hourly rate of attendees (in thousandths of currency units, eg. 50000 = $50/hr)
   time_t   lastRateChangeTS;       ///< timestamp when we last changed the total salary
-  uint32_t lastRateMilliCost;      ///< frozen cost of the meeting at the last rate change, in thousandths of currency units, eg. 12345678 = $12,345.678
-  uint32_t currentRateMilliCost;   ///< running cost of the meeting time since the last rate change, in thousandths of currency units, eg. 12345678 = $12,345.678
-  uint32_t totalMeetingMilliCost;  ///< running cost of the entire meeting (lastRateCost + currentRateCost), in thousandths of currency units, eg. 123456789 = $12,345.678
+  uint64_t lastRateMilliCost;      ///< frozen cost of the meeting at the last rate change, in thousandths of currency units, eg. 12345678 = $12,345.678
+  uint64_t currentRateMilliCost;   ///< running cost of the meeting time since the last rate change, in thousandths of currency units, eg. 12345678 = $12,345.678
+  uint64_t totalMeetingMilliCost;  ///< running cost of the entire meeting (lastRateCost + currentRateCost), in thousandths of currency units, eg. 123456789 = $12,345.678
+  time_t   meetingStartTS;         ///< timestamp when the meeting first started; 0 if it hasn't
+  uint32_t runSecs;                ///< seconds the meeting ran before lastRateChangeTS (pauses are not counted)
+  uint16_t peakAttendees;          ///< most persons attending the meeting at once
 
   Model_State status;              ///< state of the model (meeting started, stopped, reset)
+  uint16_t generations[LAST_MODEL_FIELD];  ///< per-field change counters, bumped whenever the field's value changes
 };
 
 
 MagPebApp_ErrCode Model_init(Model* this);
 MagPebApp_ErrCode Model_calculateCost(Model* this);
+MagPebApp_ErrCode Model_accrueRunTime(const Model* this, const time_t, uint32_t*);
+MagPebApp_ErrCode Model_applyFold(Model* this, const Journal_Fold*);
+void Model_touch(Model* this, const Model_Field);
+void Model_setStatus(Model* this, const Model_State);
+void Model_setTotalMilliCost(Model* this, const uint64_t);
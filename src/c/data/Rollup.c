@@ -0,0 +1,238 @@
+#include <pebble.h>
+
+// Deactivate APP_LOG in this file.
+#undef APP_LOG
+#define APP_LOG(...)
+
+#include "Rollup_Internal.h"
+#include "../misc.h"
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Constructor. A Rollup keeps running totals of the meetings held each
+/// day, week and month, so that "how much did meetings cost this week"
+/// is answered without going through the history.
+///
+/// JRB NOTE: Each period keeps two buckets: the latest one that had a
+/// meeting, and the one before it. When a meeting falls in a later
+/// period, the buckets roll over. That is all that's needed to show this
+/// period and the last, and it keeps the whole thing in one small record.
+/// Costs in different currencies can't be added up, so the totals are all
+/// in one currency, and a meeting in another one starts them over.
+/////////////////////////////////////////////////////////////////////////////
+Rollup* Rollup_create() {
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "Creating Rollup");
+  int mpaRet;
+
+  Rollup* newRollup = malloc(sizeof(*newRollup));
+  if ( (mpaRet = Rollup_init(newRollup)) != MPA_SUCCESS) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Could not initialize: %s", MagPebApp_getErrMsg(mpaRet));
+    if (newRollup != NULL) { Rollup_destroy(newRollup);  newRollup = NULL; }
+  }
+
+  return newRollup;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Internal initialization. Reads the persisted rollups.
+/// @param[in,out]  this  Pointer to Rollup; must be already allocated
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode Rollup_init(Rollup* this) {
+  MPA_RETURN_IF_NULL(this);
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "Initializing Rollup");
+
+  if ( (persist_read_data(ROLLUP_PERSIST_KEY, &this->record, sizeof(this->record)) != (int)sizeof(this->record)) ||
+       (this->record.rollupVer != ROLLUP_VER) ) {
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "No rollups.");
+    memset(&this->record, 0, sizeof(this->record));
+    this->record.rollupVer = ROLLUP_VER;
+  }
+
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Destroys Rollup and frees allocated memory. The rollups themselves stay
+/// in persistent storage.
+/// @param[in,out]  this  Pointer to Rollup; must be already allocated
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode Rollup_destroy(Rollup* this) {
+  MPA_RETURN_IF_NULL(this);
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "Destroying Rollup");
+
+  free(this); this = NULL;
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Works out which day, week or month a time falls in, in local time.
+/// Consecutive periods have consecutive ids: days are counted from
+/// 1970-01-01, weeks from the Monday before it, and months from year 0.
+/// @param[in]      period  Day, week or month
+/// @param[in]      ts   The time
+/// @param[out]     periodId   The period's id
+/// @return  MPA_SUCCESS on success
+///          MPA_NULL_POINTER_ERR if the periodId pointer is NULL.
+///          MPA_INVALID_INPUT_ERR if the period or time is not valid.
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode Rollup_getPeriodId(const Rollup_Period period, const time_t ts, uint32_t* periodId) {
+  MPA_RETURN_IF_NULL(periodId);
+
+  time_t localTS = ts;
+  struct tm* local = localtime(&localTS);
+  if ( (local == NULL) || (local->tm_year < 70) ) { return MPA_INVALID_INPUT_ERR; }
+
+  // Days since 1970-01-01, counting the leap days of the years before.
+  int32_t prevYear = local->tm_year + 1900 - 1;
+  int32_t leapDays = (prevYear / 4) - (prevYear / 100) + (prevYear / 400) - ((1969 / 4) - (1969 / 100) + (1969 / 400));
+  uint32_t dayId = (uint32_t)(365 * (prevYear - 1969) + leapDays + local->tm_yday);
+
+  switch (period) {
+    case ROLLUP_PERIOD_DAY:   *periodId = dayId;  break;
+    // 1970-01-01 was a Thursday, three days after a Monday.
+    case ROLLUP_PERIOD_WEEK:  *periodId = (dayId + 3) / 7;  break;
+    case ROLLUP_PERIOD_MONTH: *periodId = (uint32_t)((local->tm_year + 1900) * 12 + local->tm_mon);  break;
+    default: return MPA_INVALID_INPUT_ERR;
+  }
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Adds a meeting into a bucket.
+/////////////////////////////////////////////////////////////////////////////
+static MagPebApp_ErrCode Rollup_addToBucket(Rollup_Bucket* bucket, const uint32_t durationSecs, const uint64_t milliCost) {
+  MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
+
+  // The bucket is packed, so the sums are made in locals.
+  uint64_t totalMilliCost = 0;
+  uint32_t totalSecs = 0;
+  uint16_t numMeetings = 0;
+  if ( (mpaRet = u64add_u64_u64(&totalMilliCost, bucket->milliCost, milliCost)) != MPA_SUCCESS) return mpaRet;
+  if ( (mpaRet = u32add_u32_u32(&totalSecs, bucket->meetingSecs, durationSecs)) != MPA_SUCCESS) return mpaRet;
+  if ( (mpaRet = u16add_u16_u16(&numMeetings, bucket->numMeetings, 1)) != MPA_SUCCESS) return mpaRet;
+
+  bucket->milliCost = totalMilliCost;
+  bucket->meetingSecs = totalSecs;
+  bucket->numMeetings = numMeetings;
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Adds a completed meeting to the day, week and month it started in,
+/// then persists the rollups (one write). A meeting in another currency
+/// than the totals starts them over, in its currency.
+/// @param[in,out]  this  Pointer to Rollup; must be already allocated
+/// @param[in]      startTS   When the meeting started
+/// @param[in]      durationSecs   How long it ran
+/// @param[in]      milliCost   What it cost, in thousandths of currency units
+/// @param[in]      currencySymbol   The currency the cost is in (at most
+///       ROLLUP_CURRENCY_SZ - 1 bytes are kept)
+/// @return  MPA_SUCCESS on success
+///          MPA_NULL_POINTER_ERR if a pointer is NULL.
+///          MPA_INVALID_INPUT_ERR if the start time is not valid.
+///          MPA_OVERFLOW_ERR if a total would overflow (nothing is added).
+///          MPA_UNKNOWN_ERR if persistent storage could not be written.
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode Rollup_addMeeting(Rollup* this, const time_t startTS, const uint32_t durationSecs, const uint64_t milliCost, const char* currencySymbol) {
+  MPA_RETURN_IF_NULL(this);
+  MPA_RETURN_IF_NULL(currencySymbol);
+  MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
+
+  Rollup_Record record = this->record;
+  char currency[ROLLUP_CURRENCY_SZ] = { 0 };
+  strncpy(currency, currencySymbol, sizeof(currency) - 1);
+  if (strncmp(record.currencySymbol, currency, sizeof(currency)) != 0) {
+    memset(&record, 0, sizeof(record));
+    record.rollupVer = ROLLUP_VER;
+    memcpy(record.currencySymbol, currency, sizeof(currency));
+  }
+
+  for (int period=0; period<LAST_ROLLUP_PERIOD; period++) {
+    uint32_t periodId = 0;
+    if ( (mpaRet = Rollup_getPeriodId((Rollup_Period)period, startTS, &periodId)) != MPA_SUCCESS) return mpaRet;
+
+    Rollup_Bucket* current = &record.current[period];
+    Rollup_Bucket* previous = &record.previous[period];
+    Rollup_Bucket* bucket = NULL;
+    if ( (current->numMeetings == 0) || (periodId > current->periodId) ) {
+      // A later period: roll over.
+      if (current->numMeetings != 0) *previous = *current;
+      memset(current, 0, sizeof(*current));
+      current->periodId = periodId;
+      bucket = current;
+    } else if (periodId == current->periodId) {
+      bucket = current;
+    } else if ( (periodId == previous->periodId) && (previous->numMeetings != 0) ) {
+      bucket = previous;
+    } else {
+      // A period that isn't kept any more
+      continue;
+    }
+    if ( (mpaRet = Rollup_addToBucket(bucket, durationSecs, milliCost)) != MPA_SUCCESS) return mpaRet;
+  }
+
+  status_t result = 0;
+  if ( (result = persist_write_data(ROLLUP_PERSIST_KEY, &record, sizeof(record))) < 0) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Could not write rollups. Error: %ld", result);
+    return MPA_UNKNOWN_ERR;
+  }
+  this->record = record;
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Gets the totals of the period a time falls in, and of the period
+/// before it. A period without meetings comes back as an empty bucket.
+/// @param[in,out]  this  Pointer to Rollup; must be already allocated
+/// @param[in]      period  Day, week or month
+/// @param[in]      now   The time
+/// @param[out]     current   Totals of the period now falls in
+/// @param[out]     previous   Totals of the period before; may be NULL.
+/// @return  MPA_SUCCESS on success
+///          MPA_NULL_POINTER_ERR if a pointer is NULL.
+///          MPA_INVALID_INPUT_ERR if the period or time is not valid.
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode Rollup_get(const Rollup* this, const Rollup_Period period, const time_t now, Rollup_Bucket* current, Rollup_Bucket* previous) {
+  MPA_RETURN_IF_NULL(this);
+  MPA_RETURN_IF_NULL(current);
+  MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
+
+  uint32_t periodId = 0;
+  if ( (mpaRet = Rollup_getPeriodId(period, now, &periodId)) != MPA_SUCCESS) return mpaRet;
+
+  const Rollup_Bucket* kept[] = { &this->record.current[period], &this->record.previous[period] };
+  memset(current, 0, sizeof(*current));
+  current->periodId = periodId;
+  if (previous != NULL) {
+    memset(previous, 0, sizeof(*previous));
+    previous->periodId = periodId - 1;
+  }
+
+  for (size_t idx=0; idx<ARRAY_LENGTH(kept); idx++) {
+    if (kept[idx]->numMeetings == 0) continue;
+    if (kept[idx]->periodId == periodId) *current = *kept[idx];
+    if ( (previous != NULL) && (kept[idx]->periodId + 1 == periodId) ) *previous = *kept[idx];
+  }
+
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Gets the currency that the totals are in.
+/// @param[in]      this  Pointer to Rollup; must be already allocated
+/// @param[out]     currencySymbol   The currency symbol; valid until the
+///       next meeting is added. Empty if no meeting has been.
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode Rollup_getCurrencySymbol(const Rollup* this, const char** currencySymbol) {
+  MPA_RETURN_IF_NULL(this);
+  MPA_RETURN_IF_NULL(currencySymbol);
+  *currencySymbol = this->record.currencySymbol;
+  return MPA_SUCCESS;
+}
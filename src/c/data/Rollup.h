@@ -0,0 +1,41 @@
+#pragma once
+
+#include <pebble.h>
+#include "../libs/magpebapp.h"
+
+
+#define ROLLUP_PERSIST_KEY 0x1002
+#define ROLLUP_CURRENCY_SZ 8
+
+
+// Periods that meetings are totalled over (in local time)
+typedef enum Rollup_Period {
+  ROLLUP_PERIOD_DAY = 0,
+  ROLLUP_PERIOD_WEEK,         ///< ISO week: Monday to Sunday
+  ROLLUP_PERIOD_MONTH,
+
+  LAST_ROLLUP_PERIOD
+} Rollup_Period;
+
+
+// The meetings of one period, totalled
+typedef struct __attribute__((__packed__)) Rollup_Bucket {
+  uint32_t periodId;          ///< which day, week or month (see Rollup_getPeriodId)
+  uint64_t milliCost;         ///< total cost, in thousandths of currency units
+  uint32_t meetingSecs;       ///< total time spent in meetings
+  uint16_t numMeetings;
+} Rollup_Bucket;
+
+
+// Rollup struct typedef
+typedef struct Rollup Rollup;
+
+
+Rollup* Rollup_create();
+MagPebApp_ErrCode Rollup_destroy(Rollup* this);
+
+MagPebApp_ErrCode Rollup_addMeeting(Rollup* this, const time_t, const uint32_t, const uint64_t, const char*);
+MagPebApp_ErrCode Rollup_get(const Rollup* this, const Rollup_Period, const time_t, Rollup_Bucket*, Rollup_Bucket*);
+MagPebApp_ErrCode Rollup_getCurrencySymbol(const Rollup* this, const char**);
+
+MagPebApp_ErrCode Rollup_getPeriodId(const Rollup_Period, const time_t, uint32_t*);
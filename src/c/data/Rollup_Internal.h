@@ -0,0 +1,24 @@
+#include <pebble.h>
+#include "Rollup.h"
+
+
+// Version of the persisted rollups. Rollups of another version are
+// started over.
+#define ROLLUP_VER 2
+
+
+// Persisted at ROLLUP_PERSIST_KEY, as one record
+typedef struct __attribute__((__packed__)) Rollup_Record {
+  uint8_t       rollupVer;                     ///< ROLLUP_VER
+  char          currencySymbol[ROLLUP_CURRENCY_SZ];  ///< currency of every total (null-terminated)
+  Rollup_Bucket current[LAST_ROLLUP_PERIOD];   ///< the latest period that had a meeting
+  Rollup_Bucket previous[LAST_ROLLUP_PERIOD];  ///< the period before that one that had a meeting
+} Rollup_Record;
+
+
+struct Rollup {
+  Rollup_Record record;      ///< as persisted
+};
+
+
+MagPebApp_ErrCode Rollup_init(Rollup* this);
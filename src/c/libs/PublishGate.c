@@ -0,0 +1,118 @@
+#include <pebble.h>
+
+// Deactivate APP_LOG in this file.
+#undef APP_LOG
+#define APP_LOG(...)
+
+#include "PublishGate_Internal.h"
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Constructor. A PublishGate stands between a source of changes and the
+/// code that draws them. While it is open, changes pass straight through;
+/// while it is closed, they are merged into one pending mask and counted,
+/// and the whole mask passes with the next change once it is open again.
+/// Changes are bit masks of whatever fields the caller tracks.
+/////////////////////////////////////////////////////////////////////////////
+PublishGate* PublishGate_create() {
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "Creating PublishGate");
+  int mpaRet;
+
+  PublishGate* newPublishGate = malloc(sizeof(*newPublishGate));
+  if ( (mpaRet = PublishGate_init(newPublishGate)) != MPA_SUCCESS) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Could not initialize: %s", MagPebApp_getErrMsg(mpaRet));
+    newPublishGate = NULL;
+  }
+
+  return newPublishGate;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Internal initialization. The gate starts out open, with nothing held
+/// back.
+/// @param[in,out]  this  Pointer to PublishGate; must be already allocated
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode PublishGate_init(PublishGate* this) {
+  MPA_RETURN_IF_NULL(this);
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "Initializing PublishGate");
+
+  this->open = true;
+  this->pending = 0;
+  this->heldBack = 0;
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Destroys PublishGate.
+/// @param[in,out]  this  Pointer to PublishGate; must be already allocated
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode PublishGate_destroy(PublishGate* this) {
+  MPA_RETURN_IF_NULL(this);
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "Destroying PublishGate");
+
+  free(this); this = NULL;
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Opens or closes the gate. Opening it doesn't publish anything by
+/// itself: the pending changes pass with the next call to PublishGate_pass.
+/// @param[in,out]  this  Pointer to PublishGate; must be already allocated
+/// @param[in]      open  true to let changes through; false to hold them
+///       back
+///
+/// @return  MPA_SUCCESS on success
+///          MPA_NULL_POINTER_ERR if the PublishGate pointer is null
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode PublishGate_setOpen(PublishGate* this, const bool open) {
+  MPA_RETURN_IF_NULL(this);
+  this->open = open;
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Offers changes to the gate, and gets what should be published now.
+/// @param[in,out]  this  Pointer to PublishGate; must be already allocated
+/// @param[in]      changed  Mask of the fields that changed
+/// @param[out]     publish  Mask of the fields to publish now: the changes
+///       held back plus these if the gate is open, and 0 if it is closed
+///
+/// @return  MPA_SUCCESS on success
+///          MPA_NULL_POINTER_ERR if a pointer is null
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode PublishGate_pass(PublishGate* this, const uint32_t changed, uint32_t* publish) {
+  MPA_RETURN_IF_NULL(this);
+  MPA_RETURN_IF_NULL(publish);
+
+  if (this->open) {
+    *publish = this->pending | changed;
+    this->pending = 0;
+  } else {
+    *publish = 0;
+    if (changed != 0) {
+      this->pending |= changed;
+      this->heldBack++;
+    }
+  }
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Returns how many publishes were held back while the gate was closed.
+/// Offers of no changes aren't counted.
+/// @param[in,out]  this  Pointer to PublishGate; must be already allocated
+/// @param[out]     out  Pointer to the count
+///
+/// @return  MPA_SUCCESS on success
+///          MPA_NULL_POINTER_ERR if the PublishGate pointer is null
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode PublishGate_getHeldBack(PublishGate* this, uint32_t* out) {
+  MPA_RETURN_IF_NULL(this);
+  *out = this->heldBack;
+  return MPA_SUCCESS;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <pebble.h>
+#include "magpebapp.h"
+
+
+typedef struct PublishGate PublishGate;
+
+
+PublishGate* PublishGate_create();
+MagPebApp_ErrCode PublishGate_destroy(PublishGate* this);
+
+MagPebApp_ErrCode PublishGate_setOpen(PublishGate* this, const bool);
+MagPebApp_ErrCode PublishGate_pass(PublishGate* this, const uint32_t, uint32_t*);
+
+MagPebApp_ErrCode PublishGate_getHeldBack(PublishGate* this, uint32_t*);
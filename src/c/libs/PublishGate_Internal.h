@@ -0,0 +1,13 @@
+#include <pebble.h>
+#include "magpebapp.h"
+#include "PublishGate.h"
+
+
+struct PublishGate {
+  bool      open;       ///< false while publishes are held back
+  uint32_t  pending;    ///< mask of the changes held back, not yet published
+  uint32_t  heldBack;   ///< number of publishes held back since creation
+};
+
+
+MagPebApp_ErrCode PublishGate_init(PublishGate* this);
@@ -0,0 +1,182 @@
+#include <pebble.h>
+
+// Deactivate APP_LOG in this file.
+#undef APP_LOG
+#define APP_LOG(...)
+
+#include "SlotQueue_Internal.h"
+
+
+#define SLOT_QUEUE_SLOT(SQ, IDX) ((SQ)->arena + ((((SQ)->read + (IDX)) % (SQ)->capacity) * (SQ)->slotSize))
+
+/////////////////////////////////////////////////////////////////////////////
+/// Constructor. A SlotQueue is a FIFO of fixed-size slots whose storage is
+/// allocated once, up front; writing and reading slots never allocates.
+/// Slots hold their data inline, so the queue owns everything stored in it.
+/// @param[in]      capacity   Defines the number of slots available in this
+///       SlotQueue data structure.
+/// @param[in]      slotSize   Size of each slot, in bytes.
+/////////////////////////////////////////////////////////////////////////////
+SlotQueue* SlotQueue_create(size_t capacity, size_t slotSize) {
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "Creating SlotQueue [%zd x %zd]", capacity, slotSize);
+  int mpaRet;
+
+  SlotQueue* newSlotQueue = malloc(sizeof(*newSlotQueue));
+  if ( (mpaRet = SlotQueue_init(newSlotQueue, capacity, slotSize)) != MPA_SUCCESS) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Could not initialize: %s", MagPebApp_getErrMsg(mpaRet));
+    newSlotQueue = NULL;
+  }
+
+  return newSlotQueue;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Internal initialization
+/// @param[in,out]  this  Pointer to SlotQueue; must be already allocated
+/// @param[in]      capacity   Defines the number of slots in the SlotQueue
+///       data structure.
+/// @param[in]      slotSize   Size of each slot, in bytes.
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode SlotQueue_init(SlotQueue* this, size_t capacity, size_t slotSize) {
+  MPA_RETURN_IF_NULL(this);
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "Initializing SlotQueue [%zd x %zd]", capacity, slotSize);
+  MagPebApp_ErrCode myRet = MPA_OUT_OF_MEMORY_ERR;
+
+  this->arena = NULL;
+  this->read = 0;
+  this->count = 0;
+
+  if ( (capacity == 0) || (slotSize == 0) ) { myRet = MPA_INVALID_INPUT_ERR; goto freemem; }
+  this->capacity = capacity;
+  this->slotSize = slotSize;
+
+  // Allocate the storage for every slot
+  this->arena = calloc(capacity, slotSize);
+  if (this->arena == NULL) { goto freemem; }
+
+  return MPA_SUCCESS;
+
+freemem:
+  APP_LOG(APP_LOG_LEVEL_ERROR, "Error... freeing memory");
+  if (this != NULL) {
+    SlotQueue_destroy(this);  this = NULL;
+  }
+  return myRet;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Destroys SlotQueue and frees the storage for its slots.
+/// @param[in,out]  this  Pointer to SlotQueue; must be already allocated
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode SlotQueue_destroy(SlotQueue* this) {
+  MPA_RETURN_IF_NULL(this);
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "Destroying SlotQueue");
+
+  if (this->arena != NULL) {
+    free(this->arena);
+    this->arena = NULL;
+  }
+
+  free(this); this = NULL;
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Returns the number of slots in use.
+/// @param[in,out]  this  Pointer to SlotQueue; must be already allocated
+/// @param[out]     out  Pointer to the count
+///
+/// @return  MPA_SUCCESS on success
+///          MPA_NULL_POINTER_ERR if the SlotQueue pointer is null
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode SlotQueue_count(SlotQueue* this, size_t* out) {
+  MPA_RETURN_IF_NULL(this);
+  *out = this->count;
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Provides the slot at the specified position (0 is the first slot)
+/// without removing it. The slot may be modified in place.
+/// @param[in,out]  this  Pointer to SlotQueue; must be already allocated
+/// @param[in]      index  Position of the slot, counted from the first
+/// @param[out]     slot  Void double-pointer to the slot's storage.
+///
+/// @return  MPA_SUCCESS on success
+///          MPA_NULL_POINTER_ERR if the SlotQueue pointer is null
+///          MPA_EMPTY_ERR if there is no slot at that position (slot will
+///            be NULL)
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode SlotQueue_peekAt(SlotQueue* this, size_t index, void** slot) {
+  MPA_RETURN_IF_NULL(this);
+
+  if (index >= this->count) {
+    *slot = NULL;
+    return MPA_EMPTY_ERR;
+  }
+
+  *slot = SLOT_QUEUE_SLOT(this, index);
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Removes the first slot.
+/// @param[in,out]  this  Pointer to SlotQueue; must be already allocated
+///
+/// @return  MPA_SUCCESS on success
+///          MPA_NULL_POINTER_ERR if the SlotQueue pointer is null
+///          MPA_EMPTY_ERR if the SlotQueue is empty (nothing happens)
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode SlotQueue_drop(SlotQueue* this) {
+  MPA_RETURN_IF_NULL(this);
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "SlotQueue DROP");
+
+  if (this->count == 0) {
+    return MPA_EMPTY_ERR;
+  }
+
+  this->read = (this->read + 1) % this->capacity;
+  this->count--;
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Claims a new slot at the end of the queue, for the caller to fill in.
+/// @param[in,out]  this  Pointer to SlotQueue; must be already allocated
+/// @param[in]      policy  What to do if every slot is already in use
+/// @param[out]     slot  Void double-pointer to the new slot's storage,
+///       which is zero-filled.
+/// @param[out]     dropped  Set to true if the first slot was discarded to
+///       make room; may be NULL.
+///
+/// @return  MPA_SUCCESS on success
+///          MPA_NULL_POINTER_ERR if the SlotQueue pointer is null
+///          MPA_FULL_ERR if the SlotQueue is full and the policy is
+///            SLOTQUEUE_REJECT_NEW (slot will be NULL)
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode SlotQueue_write(SlotQueue* this, const SlotQueue_FullPolicy policy, void** slot, bool* dropped) {
+  MPA_RETURN_IF_NULL(this);
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "SlotQueue WRITE");
+
+  if (dropped != NULL) *dropped = false;
+
+  if (this->count == this->capacity) {
+    if (policy != SLOTQUEUE_DROP_OLDEST) {
+      *slot = NULL;
+      return MPA_FULL_ERR;
+    }
+    SlotQueue_drop(this);
+    if (dropped != NULL) *dropped = true;
+  }
+
+  this->count++;
+  *slot = SLOT_QUEUE_SLOT(this, this->count - 1);
+  memset(*slot, 0, this->slotSize);
+  return MPA_SUCCESS;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <pebble.h>
+#include "magpebapp.h"
+
+
+typedef struct SlotQueue SlotQueue;
+
+
+// What to do when writing to a full SlotQueue
+typedef enum SlotQueue_FullPolicy {
+  SLOTQUEUE_REJECT_NEW = 0,     ///< keep the queued slots; the write fails with MPA_FULL_ERR
+  SLOTQUEUE_DROP_OLDEST,        ///< discard the first slot to make room for the new one
+
+  LAST_SLOTQUEUE_POLICY
+} SlotQueue_FullPolicy;
+
+
+SlotQueue* SlotQueue_create(size_t capacity, size_t slotSize);
+MagPebApp_ErrCode SlotQueue_destroy(SlotQueue* this);
+
+MagPebApp_ErrCode SlotQueue_count(SlotQueue* this, size_t*);
+
+MagPebApp_ErrCode SlotQueue_peekAt(SlotQueue* this, size_t, void**);
+MagPebApp_ErrCode SlotQueue_drop(SlotQueue* this);
+
+MagPebApp_ErrCode SlotQueue_write(SlotQueue* this, const SlotQueue_FullPolicy, void**, bool*);
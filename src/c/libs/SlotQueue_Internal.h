@@ -0,0 +1,15 @@
+#include <pebble.h>
+#include "magpebapp.h"
+#include "SlotQueue.h"
+
+
+struct SlotQueue {
+  size_t    capacity;   ///< number of slots
+  size_t    slotSize;   ///< size of each slot, in bytes
+  size_t    read;       ///< index of the first slot
+  size_t    count;      ///< number of slots in use
+  uint8_t*  arena;      ///< storage for all slots (capacity * slotSize bytes)
+};
+
+
+MagPebApp_ErrCode SlotQueue_init(SlotQueue* this, size_t, size_t);
@@ -18,3 +18,38 @@ const char* MagPebApp_getErrMsg(const MagPebApp_ErrCode errCode) {
   } // end switch
 }
 
+
+
+#if defined(MPA_DEBUG_ALLOC)
+#undef malloc
+#undef calloc
+#undef realloc
+
+static uint32_t allocCount;
+
+/////////////////////////////////////////////////////////////////////////////
+/// Counting wrappers for the heap allocation functions (debug builds only).
+/////////////////////////////////////////////////////////////////////////////
+void* MagPebApp_debugMalloc(size_t size) {
+  allocCount++;
+  return malloc(size);
+}
+
+void* MagPebApp_debugCalloc(size_t count, size_t size) {
+  allocCount++;
+  return calloc(count, size);
+}
+
+void* MagPebApp_debugRealloc(void* ptr, size_t size) {
+  allocCount++;
+  return realloc(ptr, size);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Returns the number of heap allocations made since launch.
+/////////////////////////////////////////////////////////////////////////////
+uint32_t MagPebApp_getAllocCount() {
+  return allocCount;
+}
+#endif
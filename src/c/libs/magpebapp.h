@@ -28,6 +28,20 @@ typedef enum MagPebApp_ErrCode {
 const char* MagPebApp_getErrMsg(const MagPebApp_ErrCode errCode);
 
 
+// Define MPA_DEBUG_ALLOC (eg. MPA_DEBUG_ALLOC=1 in the environment when
+// building) to count heap allocations made by the app.
+#if defined(MPA_DEBUG_ALLOC)
+void* MagPebApp_debugMalloc(size_t size);
+void* MagPebApp_debugCalloc(size_t count, size_t size);
+void* MagPebApp_debugRealloc(void* ptr, size_t size);
+uint32_t MagPebApp_getAllocCount();
+
+#define malloc(size)        MagPebApp_debugMalloc(size)
+#define calloc(count,size)  MagPebApp_debugCalloc(count, size)
+#define realloc(ptr,size)   MagPebApp_debugRealloc(ptr, size)
+#endif
+
+
 typedef struct MPA_Palette {
   GColor normalBack;
   GColor normalFore;
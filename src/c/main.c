@@ -1,14 +1,35 @@
 #include <pebble.h>
 
-// Deactivate APP_LOG in this file.
+// Deactivate APP_LOG in this file, unless measuring startup.
+#if !defined(MPA_DEBUG_TIMING)
 #undef APP_LOG
 #define APP_LOG(...)
+#endif
 
 #include "comm.h"
 #include "misc.h"
+#include "ui/wndHistory.h"
 #include "ui/wndMain.h"
 #include "ui/wndSettings.h"
 
+// When main() started, for measuring startup latency
+static time_t launchSecs;
+static uint16_t launchMs;
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Logs how long it took from main() until the meeting cost was on screen.
+/////////////////////////////////////////////////////////////////////////////
+static void costRendered() {
+  time_t nowSecs = 0;
+  uint16_t nowMs = 0;
+  time_ms(&nowSecs, &nowMs);
+
+  int32_t latencyMs = (int32_t)(nowSecs - launchSecs) * 1000 + nowMs - launchMs;
+  APP_LOG(APP_LOG_LEVEL_INFO, "Startup latency: %ld ms (main() to first rendered cost)", latencyMs);
+  (void) latencyMs;  // silence the unused variable warning when APP_LOG is off
+}
+
 
 /////////////////////////////////////////////////////////////////////////////
 /// Used for the creation of all Pebble SDK elements.
@@ -24,23 +45,34 @@ static void init() {
   wndMain_createPush();
   wndMain_setPalette(colors);
   wndSettings_setPalette(colors);
+  wndHistory_setPalette(colors);
   wndMain_setHandlers( (wndMainHandlers) {
-    .adjustAttendance = comm_adjustAttendance
+    .adjustAttendance = comm_adjustAttendance,
+    .costRendered = costRendered
   });
 
   wndSettings_setHandlers( (wndSettingsHandlers) {
     .toggleMeeting = comm_toggleMeeting,
-    .resetMeeting = comm_resetMeeting
+    .resetMeeting = comm_resetMeeting,
+    .getRollup = comm_getRollup
+  });
+
+  wndHistory_setHandlers( (wndHistoryHandlers) {
+    .getCount = comm_getHistoryCount,
+    .getRecord = comm_getHistoryRecord
   });
 
   comm_setHandlers( (CommHandlers) {
-    .updateViewTime = wndMain_updateTime,
-    .updateViewData = wndMain_updateData
+    .updateViewTime = wndMain_updateTime
   });
+  comm_subscribe(wndMain_updateData, MODEL_FIELD_BIT(MODEL_FIELD_COST) | MODEL_FIELD_BIT(MODEL_FIELD_ATTENDEES) | MODEL_FIELD_BIT(MODEL_FIELD_CURRENCY));
+  comm_subscribe(wndSettings_updateData, MODEL_FIELD_BIT(MODEL_FIELD_STATUS));
+
+  // Applies the saved settings, so the first frame already shows them
   comm_open();
 
-  // Register with TickTimerService
-  tick_timer_service_subscribe(SECOND_UNIT, comm_tickHandler);
+  // Wake up only when the displayed cost or clock will change
+  comm_scheduleUpdate();
 }
 
 
@@ -48,6 +80,9 @@ static void init() {
 /// Used for the destruction of all Pebble SDK elements.
 /////////////////////////////////////////////////////////////////////////////
 static void deinit() {
+  // Leave the cost in the launcher, so checking it needs no relaunch
+  comm_publishGlance();
+
   wndMain_destroy();
 
   comm_close();
@@ -58,6 +93,7 @@ static void deinit() {
 /// Standard Pebble main function
 /////////////////////////////////////////////////////////////////////////////
 int main(void) {
+  time_ms(&launchSecs, &launchMs);
   init();
   app_event_loop();
   deinit();
@@ -260,6 +260,56 @@ MagPebApp_ErrCode u32mult_u32_u32(uint32_t* product, const uint32_t multiplicand
 }
 
 
+/////////////////////////////////////////////////////////////////////////////
+/// Checks for integer overflow before performing an addition operation.
+/// This code largely borrowed from https://www.fefe.de/intof.html and from
+/// http://c-faq.com/misc/intovf.html
+///
+/// @param[in,out]  sum  Pointer will equal the sum of the addition, if no
+///       overflow would occur. Upon entry to this function, this must point
+///       to a valid variable.
+/// @param[in]      augend  first number to add
+/// @param[in]      addend  second number to add
+///
+/// @return  MPA_SUCCESS on success
+///          MPA_NULL_POINTER_ERR if the sum pointer is NULL.
+///          MPA_OVERFLOW_ERR if the addition would cause an integer overflow
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode u64add_u64_u64(uint64_t* sum, const uint64_t augend, const uint64_t addend) {
+  MPA_RETURN_IF_NULL(sum);
+  if (MPA_MAX(uint64_t) - addend < augend)  return MPA_OVERFLOW_ERR;
+  *sum = augend + addend;
+  return MPA_SUCCESS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Checks for integer overflow before performing a multiplication operation.
+/// When the multiplicand fits in 32 bits, the product cannot overflow, so
+/// the (comparatively expensive) 64-bit division used for the overflow test
+/// is skipped. The multiply itself is still 64x32; callers whose operands
+/// are both 32-bit should widen one and multiply directly instead.
+///
+/// @param[in,out]  product  The variable that will hold the product, if no
+///       overflow would occur. Upon entry to this function, this must point
+///       to a valid variable.
+/// @param[in]      multiplicand  first number to multiply
+/// @param[in]      multiplier  second number to multiply
+///
+/// @return  MPA_SUCCESS on success
+///          MPA_NULL_POINTER_ERR if the product pointer is NULL.
+///          MPA_OVERFLOW_ERR if the multiplication would cause an integer overflow
+/////////////////////////////////////////////////////////////////////////////
+MagPebApp_ErrCode u64mult_u64_u32(uint64_t* product, const uint64_t multiplicand, const uint32_t multiplier) {
+  MPA_RETURN_IF_NULL(product);
+  if ( (multiplicand > MPA_MAX(uint32_t)) && (multiplier != 0) ) {
+    if (multiplicand > (MPA_MAX(uint64_t) / multiplier)) return MPA_OVERFLOW_ERR;
+  }
+  *product = multiplicand * multiplier;
+  return MPA_SUCCESS;
+}
+
+
 /////////////////////////////////////////////////////////////////////////////
 /// Checks for integer overflow before performing a multiplication operation.
 /// This code largely borrowed from:
@@ -374,30 +424,6 @@ MagPebApp_ErrCode s32RoundNear(int32_t* rounded, const int32_t numToRound, const
 }
 
 
-/////////////////////////////////////////////////////////////////////////////
-/// Stylizes the text layer to the spec
-/////////////////////////////////////////////////////////////////////////////
-void textLayer_stylize(TextLayer* textLayer, const GColor bgcolor, const GColor txtColor,
-                       const GTextAlignment txtAlign, const GFont txtFont) {
-  if (!textLayer) {
-    APP_LOG(APP_LOG_LEVEL_WARNING, "Attempting to stylize before text layer is created!");
-  } else {
-    text_layer_set_background_color(textLayer, bgcolor);
-    text_layer_set_text_color(textLayer, txtColor);
-    text_layer_set_text_alignment(textLayer, txtAlign);
-    text_layer_set_font(textLayer, txtFont);
-  }
-}
-
-
-/////////////////////////////////////////////////////////////////////////////
-/// Helper function for calculating relative coordinates.
-/////////////////////////////////////////////////////////////////////////////
-uint16_t rel2Pxl(const uint16_t max, const uint8_t pct) {
-  return (pct * max) / 100;
-}
-
-
 /////////////////////////////////////////////////////////////////////////////
 /// Copies a string with error handling and logging.
 /////////////////////////////////////////////////////////////////////////////
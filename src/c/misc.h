@@ -87,6 +87,8 @@ MagPebApp_ErrCode s32add_u32_u32(int32_t* sum, const uint32_t augend, const uint
 MagPebApp_ErrCode s32add_u32_s32(int32_t* sum, const uint32_t augend, const int32_t addend);
 MagPebApp_ErrCode s32add_s32_s32(int32_t* sum, const int32_t augend, const int32_t addend);
 MagPebApp_ErrCode u32mult_u32_u32(uint32_t* product, const uint32_t multiplicand, const uint32_t multiplier);
+MagPebApp_ErrCode u64add_u64_u64(uint64_t* sum, const uint64_t augend, const uint64_t addend);
+MagPebApp_ErrCode u64mult_u64_u32(uint64_t* product, const uint64_t multiplicand, const uint32_t multiplier);
 
 MagPebApp_ErrCode s32mult_s32_s32(int32_t* product, const int32_t multiplicand, const int32_t multiplier);
 
@@ -94,14 +96,6 @@ MagPebApp_ErrCode s32RoundUp(int32_t* rounded, const int32_t numToRound, const i
 MagPebApp_ErrCode s32RoundNear(int32_t* rounded, const int32_t numToRound, const int32_t multiple);
 
 
-// Pebble UI functions
-void textLayer_stylize(TextLayer*, const GColor, const GColor, const GTextAlignment, const GFont);
-
-uint16_t rel2Pxl(const uint16_t max, const uint8_t pct);
-// JRB NOTE: A couple of helper macros for succinct-looking code. As with all macros, use wisely.
-#define RELH(MAX,PCT) (rel2Pxl(MAX.size.h, PCT))
-#define RELW(MAX,PCT) (rel2Pxl(MAX.size.w, PCT))
-
 // String functions
 bool strxcpy(char* buffer, size_t bufsize, const char* source, const char* readable);
 MagPebApp_ErrCode strxcpyalloc(char** dest, const char* src);
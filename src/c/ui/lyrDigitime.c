@@ -5,9 +5,11 @@
 #define APP_LOG(...)
 
 #include "../misc.h"
+#include "uiMisc.h"
 #include "lyrDigitime.h"
 
 static TextLayer *lyrDigitime;
+static int shownMinuteOfDay = -1;   ///< minute of the day currently displayed, or -1 if none
 
 
 /////////////////////////////////////////////////////////////////////////////
@@ -20,6 +22,7 @@ void lyrDigitime_create(const GRect position, Layer* lyrParent) {
   }
   lyrDigitime = text_layer_create(position);
   text_layer_set_text(lyrDigitime, "00:00");
+  shownMinuteOfDay = -1;
   lyrDigitime_updateTime(NULL);
   layer_add_child(lyrParent, text_layer_get_layer(lyrDigitime));
 }
@@ -73,6 +76,11 @@ MagPebApp_ErrCode lyrDigitime_updateTime(struct tm* in_time) {
     curr_time = localtime(&temp);
   }
 
+  // Only reformat when the displayed minute changes
+  int minuteOfDay = curr_time->tm_hour * 60 + curr_time->tm_min;
+  if (minuteOfDay == shownMinuteOfDay) return MPA_SUCCESS;
+  shownMinuteOfDay = minuteOfDay;
+
   // Write the current hours and minutes into a buffer
   static char buffer[10];
   strftime(buffer, sizeof(buffer), clock_is_24h_style() ?
@@ -0,0 +1,32 @@
+#include <pebble.h>
+
+// Deactivate APP_LOG in this file.
+#undef APP_LOG
+#define APP_LOG(...)
+
+#include "uiMisc.h"
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Stylizes the text layer to the spec
+/////////////////////////////////////////////////////////////////////////////
+void textLayer_stylize(TextLayer* textLayer, const GColor bgcolor, const GColor txtColor,
+                       const GTextAlignment txtAlign, const GFont txtFont) {
+  if (!textLayer) {
+    APP_LOG(APP_LOG_LEVEL_WARNING, "Attempting to stylize before text layer is created!");
+  } else {
+    text_layer_set_background_color(textLayer, bgcolor);
+    text_layer_set_text_color(textLayer, txtColor);
+    text_layer_set_text_alignment(textLayer, txtAlign);
+    text_layer_set_font(textLayer, txtFont);
+  }
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Helper function for calculating relative coordinates.
+/////////////////////////////////////////////////////////////////////////////
+uint16_t rel2Pxl(const uint16_t max, const uint8_t pct) {
+  return (pct * max) / 100;
+}
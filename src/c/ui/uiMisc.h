@@ -0,0 +1,11 @@
+#pragma once
+
+#include <pebble.h>
+
+// Pebble UI functions
+void textLayer_stylize(TextLayer*, const GColor, const GColor, const GTextAlignment, const GFont);
+
+uint16_t rel2Pxl(const uint16_t max, const uint8_t pct);
+// JRB NOTE: A couple of helper macros for succinct-looking code. As with all macros, use wisely.
+#define RELH(MAX,PCT) (rel2Pxl(MAX.size.h, PCT))
+#define RELW(MAX,PCT) (rel2Pxl(MAX.size.w, PCT))
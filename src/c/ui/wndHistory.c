@@ -0,0 +1,262 @@
+#include <pebble.h>
+
+// Deactivate APP_LOG in this file.
+#undef APP_LOG
+#define APP_LOG(...)
+
+#include "../misc.h"
+#include "../data/History.h"
+
+#include "wndHistory.h"
+
+#define NUM_MENU_SECTIONS 1
+
+// JRB NOTE: The history can hold hundreds of meetings, so rows are not
+// kept in memory. The MenuLayer asks for rows as they come into view;
+// each one is read from persistent storage, formatted, and kept in a
+// small cache, least recently drawn out first. The cache is a few more
+// rows than fit on screen, so scrolling by one row reads one meeting.
+#define ROW_CACHE_SZ 6
+#define ROW_TITLE_SZ 24
+#define ROW_SUBTITLE_SZ 32
+
+typedef struct HistoryRow {
+  size_t   index;                        ///< meeting shown in this row; 0 is the most recent
+  uint32_t lastDrawn;                    ///< when the row was last drawn (in cache ticks); 0 if the slot is free
+  char     title[ROW_TITLE_SZ];          ///< cost
+  char     subtitle[ROW_SUBTITLE_SZ];    ///< start, duration and peak attendance
+} HistoryRow;
+
+static Window* wndHistory;
+static MPA_Palette colors;
+static MenuLayer* lyrHistory;
+static wndHistoryHandlers myHandlers;
+
+static HistoryRow rowCache[ROW_CACHE_SZ];
+static uint32_t rowCacheTick;
+static size_t numMeetings;      ///< as of when the window was loaded
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Forgets every cached row.
+/////////////////////////////////////////////////////////////////////////////
+static void wndHistory_clearCache() {
+  memset(rowCache, 0, sizeof(rowCache));
+  rowCacheTick = 0;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Formats a meeting into a row.
+/////////////////////////////////////////////////////////////////////////////
+static void wndHistory_fmtRow(HistoryRow* row, const History_Record* record) {
+  // JRB NOTE: Pebble's printf doesn't do 64-bit integers.
+  uint64_t wholeUnits = record->milliCost / 1000;
+  if (wholeUnits > MPA_MAX(uint32_t)) {
+    strxcpy(row->title, sizeof(row->title), "Too Costly", NULL);
+  } else {
+    snprintf(row->title, sizeof(row->title), "%s%lu.%02lu", record->currencySymbol, (unsigned long)wholeUnits, (unsigned long)(record->milliCost % 1000) / 10);
+  }
+
+  char started[16] = "";
+  time_t startTS = (time_t)record->startTS;
+  struct tm* startTime = localtime(&startTS);
+  if (startTime != NULL) strftime(started, sizeof(started), "%b %d %H:%M", startTime);
+
+  uint32_t mins = (record->durationSecs + 59) / 60;
+  snprintf(row->subtitle, sizeof(row->subtitle), "%s %lu:%02lu x%u", started, (unsigned long)mins / 60, (unsigned long)mins % 60, record->peakAttendees);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Gets a row from the cache, reading and formatting the meeting if it
+/// isn't there (in place of the least recently drawn row).
+/// @return  NULL if the meeting could not be read
+/////////////////////////////////////////////////////////////////////////////
+static const HistoryRow* wndHistory_getRow(const size_t index) {
+  HistoryRow* victim = &rowCache[0];
+  rowCacheTick++;
+
+  for (size_t slot=0; slot<ROW_CACHE_SZ; slot++) {
+    HistoryRow* row = &rowCache[slot];
+    if ( (row->lastDrawn != 0) && (row->index == index) ) {
+      row->lastDrawn = rowCacheTick;
+      return row;
+    }
+    if (row->lastDrawn < victim->lastDrawn) victim = row;
+  }
+
+  if (!myHandlers.getRecord) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Attempted operation on NULL pointer.");
+    return NULL;
+  }
+  History_Record record;
+  if (!(*myHandlers.getRecord)(index, &record)) return NULL;
+
+  wndHistory_fmtRow(victim, &record);
+  victim->index = index;
+  victim->lastDrawn = rowCacheTick;
+  return victim;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+static uint16_t wndHistory_get_num_sections_callback(MenuLayer* menu_layer, void* data) {
+  return NUM_MENU_SECTIONS;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+static uint16_t wndHistory_get_num_rows_callback(MenuLayer* menu_layer, uint16_t section_index, void* data) {
+  switch (section_index) {
+    case 0:
+      // An empty history still shows a row, to say so.
+      if (numMeetings == 0) return 1;
+      return (numMeetings > MPA_MAX(uint16_t)) ? MPA_MAX(uint16_t) : (uint16_t)numMeetings;
+    default:
+      return 0;
+  }
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+static void wndHistory_draw_row_callback(GContext* ctx, const Layer* cell_layer, MenuIndex* cell_index, void* data) {
+  if (numMeetings == 0) {
+    menu_cell_basic_draw(ctx, cell_layer, "No Meetings Yet", NULL, NULL);
+    return;
+  }
+
+  const HistoryRow* row = wndHistory_getRow(cell_index->row);
+  if (row == NULL) {
+    menu_cell_basic_draw(ctx, cell_layer, "Unavailable", NULL, NULL);
+  } else {
+    menu_cell_basic_draw(ctx, cell_layer, row->title, row->subtitle, NULL);
+  }
+}
+
+
+#if defined(PBL_ROUND)
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+static int16_t wndHistory_get_cell_height_callback(MenuLayer* menu_layer, MenuIndex* cell_index, void* callback_context) {
+  Layer* lyrRoot = window_get_root_layer(wndHistory);
+  GRect bounds = layer_get_bounds(lyrRoot);
+  return (int)(bounds.size.h / 3);
+}
+#endif
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Sets our callback handlers.
+/////////////////////////////////////////////////////////////////////////////
+void wndHistory_setHandlers(const wndHistoryHandlers whh) {
+  myHandlers = whh;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Sets the color palette.
+/////////////////////////////////////////////////////////////////////////////
+void wndHistory_setPalette(const MPA_Palette pal) {
+  colors = pal;
+  if (wndHistory) {
+    window_set_background_color(wndHistory, colors.normalBack);
+  }
+  if (lyrHistory) {
+    menu_layer_set_normal_colors(lyrHistory, colors.normalBack, colors.normalFore);
+    menu_layer_set_highlight_colors(lyrHistory, colors.highltBack, colors.highltFore);
+  }
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+static void wndHistory_load(Window* window) {
+  window_set_background_color(window, colors.normalBack);
+  Layer* lyrRoot = window_get_root_layer(window);
+  GRect bounds = layer_get_unobstructed_bounds(lyrRoot);
+
+  if (lyrHistory) {
+    APP_LOG(APP_LOG_LEVEL_WARNING, "Attempting to re-create layer before destroying.");
+    return;
+  }
+
+  // The history may have grown since the window was last shown, which
+  // shifts every row down.
+  wndHistory_clearCache();
+  numMeetings = 0;
+  if (!myHandlers.getCount) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Attempted operation on NULL pointer.");
+  } else if (!(*myHandlers.getCount)(&numMeetings)) {
+    numMeetings = 0;
+  }
+
+  lyrHistory = menu_layer_create(bounds);
+  menu_layer_set_callbacks(lyrHistory, NULL, (MenuLayerCallbacks) {
+    .get_num_sections = wndHistory_get_num_sections_callback,
+    .get_num_rows = wndHistory_get_num_rows_callback,
+    .draw_row = wndHistory_draw_row_callback,
+    .get_cell_height = PBL_IF_ROUND_ELSE(wndHistory_get_cell_height_callback, NULL)
+  });
+
+  menu_layer_set_normal_colors(lyrHistory, colors.normalBack, colors.normalFore);
+  menu_layer_set_highlight_colors(lyrHistory, colors.highltBack, colors.highltFore);
+
+  menu_layer_set_click_config_onto_window(lyrHistory, window);
+  layer_add_child(lyrRoot, menu_layer_get_layer(lyrHistory));
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+static void wndHistory_unload(Window* window) {
+  if (!lyrHistory) {
+    APP_LOG(APP_LOG_LEVEL_WARNING, "Attempting to destroy a null pointer!");
+  } else {
+    menu_layer_destroy(lyrHistory);   lyrHistory = NULL;
+  }
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+void wndHistory_push() {
+  if (!wndHistory) APP_LOG(APP_LOG_LEVEL_ERROR, "Attempted operation on NULL pointer.");
+  else window_stack_push(wndHistory, true);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+void wndHistory_create() {
+  if (wndHistory) {
+    APP_LOG(APP_LOG_LEVEL_WARNING, "Attempting to re-create window before destroying.");
+    return;
+  }
+  wndHistory = window_create();
+
+  INIT_MPA_PALETTE(colors);
+  (void) colors;  // silence the unused variable warning
+
+  // Set handlers to manage the elements inside the Window
+  window_set_window_handlers(wndHistory, (WindowHandlers) {
+    .load =   wndHistory_load,
+    .unload = wndHistory_unload
+  });
+
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+void wndHistory_destroy() {
+  if (!wndHistory) {
+    APP_LOG(APP_LOG_LEVEL_WARNING, "Attempting to destroy a null pointer!");
+  } else {
+    window_destroy(wndHistory);
+    wndHistory = NULL;
+  }
+}
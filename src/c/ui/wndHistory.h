@@ -0,0 +1,28 @@
+#pragma once
+#include <pebble.h>
+
+#include "../data/History.h"
+
+// GetHistoryCountHandler is a pointer to a function that takes a single
+// parameter (size_t pointer, for the number of past meetings) and returns
+// whether it succeeded.
+typedef bool (*GetHistoryCountHandler)(size_t*);
+
+// GetHistoryRecordHandler is a pointer to a function that takes two
+// parameters (index of a past meeting, where 0 is the most recent; record
+// pointer, for the meeting) and returns whether it succeeded.
+typedef bool (*GetHistoryRecordHandler)(const size_t, History_Record*);
+
+// wndHistoryHandlers is a struct that contains the values of the handlers.
+typedef struct wndHistoryHandlers {
+  GetHistoryCountHandler  getCount;     ///< Function that this View calls to get data from its Controller.
+  GetHistoryRecordHandler getRecord;    ///< Function that this View calls to get data from its Controller.
+} wndHistoryHandlers;
+
+
+void wndHistory_setHandlers(const wndHistoryHandlers);
+void wndHistory_setPalette(const MPA_Palette);
+
+void wndHistory_create();
+void wndHistory_push();
+void wndHistory_destroy();
@@ -6,6 +6,7 @@
 
 #include "../data/Model.h"
 #include "../misc.h"
+#include "uiMisc.h"
 #include "wndMain.h"
 #include "wndSettings.h"
 #include "lyrDigitime.h"
@@ -17,6 +18,16 @@ static GBitmap *bmpPersonPlus, *bmpPersonMinus, *bmpSettings, *bmpAttendIcon;
 static TextLayer* lyrMeetingCost;
 static TextLayer* lyrAttendees;
 static BitmapLayer* lyrAttendIcon;
+static Layer* lyrCostDrawn;
+static bool costRenderReported;
+
+// Displayed strings
+static char meetingCostBuf[FMTD_COST_SZ];
+static char attendeesBuf[16];
+
+// Model fields that changed while the window was not loaded
+static const Model* dataModel;
+static Model_FieldMask pendingFields;
 
 static wndMainHandlers myHandlers;
 
@@ -48,6 +59,9 @@ void wndMain_setPalette(const MPA_Palette pal) {
 /// Updates the displayed digital time
 /////////////////////////////////////////////////////////////////////////////
 void wndMain_updateTime(struct tm* in_time) {
+  // Nothing to draw on; wndMain_load shows the time when the window loads.
+  if (!wndMain || !window_is_loaded(wndMain)) return;
+
   MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
   struct tm* curr_time = NULL;
 
@@ -67,36 +81,36 @@ void wndMain_updateTime(struct tm* in_time) {
 
 
 /////////////////////////////////////////////////////////////////////////////
-/// Updates the displayed information.
+/// Updates the displayed information. Only the layers whose data changed
+/// are touched, and strings are formatted straight into the static buffers
+/// the text layers display, so an update allocates nothing.
+/// @param[in]      model  The data model
+/// @param[in]      changed  Mask of the Model fields that changed
 /////////////////////////////////////////////////////////////////////////////
-void wndMain_updateData(const Model* model) {
-  if (!wndMain) return;
-  wndSettings_updateData(model);
-  if (!window_is_loaded(wndMain)) return;
+void wndMain_updateData(const Model* model, const Model_FieldMask changed) {
+  dataModel = model;
+  if (!wndMain || !window_is_loaded(wndMain)) {
+    pendingFields |= changed;
+    return;
+  }
   MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
   long lret = 0;
 
   // Update meeting cost
-  char* meetingCost = NULL;
-  static char meetingCostBuf[16];
-  if ( (mpaRet = Model_getFmtdMeetingCost(model, &meetingCost)) != MPA_SUCCESS) {
-    APP_LOG(APP_LOG_LEVEL_ERROR, "Could not get string: %s", MagPebApp_getErrMsg(mpaRet));
-  } else {
-    if (!(lret = strxcpy(meetingCostBuf, sizeof(meetingCostBuf), meetingCost, "Meeting cost"))) {
-      APP_LOG(APP_LOG_LEVEL_ERROR, "String was not written correctly. Ret=%ld", lret);
+  if (changed & (MODEL_FIELD_BIT(MODEL_FIELD_COST) | MODEL_FIELD_BIT(MODEL_FIELD_CURRENCY))) {
+    if ( (mpaRet = Model_getFmtdMeetingCost(model, meetingCostBuf, sizeof(meetingCostBuf))) != MPA_SUCCESS) {
+      APP_LOG(APP_LOG_LEVEL_ERROR, "Could not get string: %s", MagPebApp_getErrMsg(mpaRet));
     } else {
       text_layer_set_text(lyrMeetingCost, meetingCostBuf);
     }
   }
-  if (meetingCost != NULL) { free(meetingCost);  meetingCost = NULL; }
 
   // Update attendees
-  uint16_t numAttendees = 0;
-  static char attendeesBuf[16];
-  if ( (mpaRet = Model_getNumAttendees(model, &numAttendees)) != MPA_SUCCESS) {
-    APP_LOG(APP_LOG_LEVEL_ERROR, "Could not get value: %s", MagPebApp_getErrMsg(mpaRet));
-  } else {
-    if ( (lret = snprintf(attendeesBuf, sizeof(attendeesBuf), "%d", numAttendees)) < 0) {
+  if (changed & MODEL_FIELD_BIT(MODEL_FIELD_ATTENDEES)) {
+    uint16_t numAttendees = 0;
+    if ( (mpaRet = Model_getNumAttendees(model, &numAttendees)) != MPA_SUCCESS) {
+      APP_LOG(APP_LOG_LEVEL_ERROR, "Could not get value: %s", MagPebApp_getErrMsg(mpaRet));
+    } else if ( (lret = snprintf(attendeesBuf, sizeof(attendeesBuf), "%d", numAttendees)) < 0) {
       APP_LOG(APP_LOG_LEVEL_ERROR, "String was not written correctly. Ret=%ld", lret);
     } else if ((size_t)lret >= sizeof(attendeesBuf)) {
       APP_LOG(APP_LOG_LEVEL_WARNING, "String was truncated. %ld characters required.", lret);
@@ -186,6 +200,20 @@ static void unobstructedChange(AnimationProgress progress, void *context) {
 */
 
 
+/////////////////////////////////////////////////////////////////////////////
+/// Draws nothing. Its layer sits on top of the meeting cost, so it runs
+/// just after the cost is drawn, and reports the first time that happens.
+/////////////////////////////////////////////////////////////////////////////
+static void wndMain_costDrawnUpdateProc(Layer* layer, GContext* ctx) {
+  if (costRenderReported || (meetingCostBuf[0] == '\0') ) return;
+  costRenderReported = true;
+
+  if (myHandlers.costRendered != NULL) {
+    (*myHandlers.costRendered)();
+  }
+}
+
+
 /////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////
 static void wndMain_load(Window* window) {
@@ -218,6 +246,9 @@ static void wndMain_load(Window* window) {
   textLayer_stylize(lyrMeetingCost, GColorClear, colors.normalFore, GTextAlignmentCenter, fonts_get_system_font(FONT_KEY_GOTHIC_28_BOLD));
   text_layer_set_text(lyrMeetingCost, "");
   layer_add_child(lyrRoot, text_layer_get_layer(lyrMeetingCost));
+  lyrCostDrawn = layer_create(layer_get_bounds(text_layer_get_layer(lyrMeetingCost)));
+  layer_set_update_proc(lyrCostDrawn, wndMain_costDrawnUpdateProc);
+  layer_add_child(text_layer_get_layer(lyrMeetingCost), lyrCostDrawn);
 
   // Number of attendees
   GRect rctNumAttend = GRect(RELW(bounds, 50), RELH(bounds, relHtAttend), RELW(bounds, 30), 30);
@@ -247,6 +278,12 @@ static void wndMain_load(Window* window) {
   unobstructed_area_service_subscribe(handlers, NULL);
 */
 
+  // Catch up on anything that changed before the layers existed
+  if (dataModel != NULL) {
+    wndMain_updateData(dataModel, pendingFields);
+  }
+  pendingFields = 0;
+  wndMain_updateTime(NULL);
 }
 
 
@@ -258,6 +295,7 @@ static void wndMain_unload(Window* window) {
 
   // Destroy text layers
   text_layer_destroy(lyrAttendees);    lyrAttendees = NULL;
+  layer_destroy(lyrCostDrawn);  lyrCostDrawn = NULL;
   text_layer_destroy(lyrMeetingCost);  lyrMeetingCost = NULL;
 
   // Destroy the ActionBarLayer
@@ -6,9 +6,14 @@
 // two integer parameters and returns nothing.
 typedef void (*AdjustAttendanceHandler)(const int16_t, const uint16_t);
 
+// CostRenderedHandler is a pointer to a function that takes no parameters
+// and returns nothing.
+typedef void (*CostRenderedHandler)();
+
 // wndMainHandlers is a struct that contains the values of the handlers.
 typedef struct wndMainMenuHandlers {
   AdjustAttendanceHandler adjustAttendance;   ///< Function that this View calls to request data changes of its Controller.
+  CostRenderedHandler     costRendered;       ///< Optional. Function that this View calls once, when a meeting cost is first drawn.
 } wndMainHandlers;
 
 
@@ -17,7 +22,7 @@ void wndMain_setPalette(const MPA_Palette);
 
 
 void wndMain_updateTime(struct tm*);
-void wndMain_updateData(const Model*);
+void wndMain_updateData(const Model*, const Model_FieldMask);
 void wndMain_create();
 void wndMain_push();
 void wndMain_createPush();
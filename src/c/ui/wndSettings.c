@@ -7,6 +7,7 @@
 #include "../misc.h"
 #include "../data/Model.h"
 
+#include "wndHistory.h"
 #include "wndSettings.h"
 
 #define NUM_MENU_SECTIONS 1
@@ -14,6 +15,8 @@
 enum MenuItems {
   MNU_ITEM_TOGGLE_MTG = 0,
   MNU_ITEM_RESET_MTG,
+  MNU_ITEM_ROLLUP,
+  MNU_ITEM_HISTORY,
 
 #if 0
   MNU_ITEM_DEFAULT_PAY_RATE,
@@ -24,6 +27,7 @@ enum MenuItems {
 
 
 #define STATUS_MSG_SZ 32
+#define ROLLUP_MSG_SZ 32
 
 static Window* wndSettings;
 static MPA_Palette colors;
@@ -33,6 +37,42 @@ static char statusMsg[STATUS_MSG_SZ];
 
 static const Model* dataModel;
 static Model_State mtgStatus = MODEL_STATE_NO_ATTENDEES;
+static Rollup_Period rollupPeriod = ROLLUP_PERIOD_WEEK;   ///< period shown on the rollup row; select cycles it
+
+static const char* const rollupPeriodNames[LAST_ROLLUP_PERIOD] = { "Today", "This Week", "This Month" };
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Draws the rollup row: what past meetings cost in the current period.
+/// The totals are kept up to date as meetings end, so getting them reads
+/// nothing from storage. They are labelled with the currency the meetings
+/// were in, not the one currently set.
+/////////////////////////////////////////////////////////////////////////////
+static void wndSettings_drawRollupRow(GContext* ctx, const Layer* cell_layer) {
+  Rollup_Bucket bucket;
+  const char* currSym = NULL;
+  if ( !myHandlers.getRollup || !(*myHandlers.getRollup)(rollupPeriod, &bucket, &currSym) ) {
+    menu_cell_basic_draw(ctx, cell_layer, rollupPeriodNames[rollupPeriod], "Unavailable", NULL);
+    return;
+  }
+  if (currSym == NULL) currSym = "";
+
+  // JRB NOTE: Pebble's printf doesn't do 64-bit integers.
+  char title[ROLLUP_MSG_SZ];
+  uint64_t wholeUnits = bucket.milliCost / 1000;
+  if (wholeUnits > MPA_MAX(uint32_t)) {
+    snprintf(title, sizeof(title), "%s: Too Costly", rollupPeriodNames[rollupPeriod]);
+  } else {
+    snprintf(title, sizeof(title), "%s: %s%lu", rollupPeriodNames[rollupPeriod], currSym, (unsigned long)wholeUnits);
+  }
+
+  char subtitle[ROLLUP_MSG_SZ];
+  uint32_t mins = bucket.meetingSecs / 60;
+  snprintf(subtitle, sizeof(subtitle), "%u mtg%s, %lu:%02lu h", bucket.numMeetings, (bucket.numMeetings == 1) ? "" : "s", (unsigned long)mins / 60, (unsigned long)mins % 60);
+
+  menu_cell_basic_draw(ctx, cell_layer, title, subtitle, NULL);
+}
+
 
 /////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////
@@ -69,6 +109,14 @@ static void wndSettings_draw_row_callback(GContext* ctx, const Layer* cell_layer
           menu_cell_basic_draw(ctx, cell_layer, "Reset Meeting", NULL, NULL);
           break;
 
+        case MNU_ITEM_ROLLUP:
+          wndSettings_drawRollupRow(ctx, cell_layer);
+          break;
+
+        case MNU_ITEM_HISTORY:
+          menu_cell_basic_draw(ctx, cell_layer, "Past Meetings", NULL, NULL);
+          break;
+
 #if 0
         case MNU_ITEM_ACKNOWLEDGEMENTS:
           menu_cell_basic_draw(ctx, cell_layer, "Acknowledgements", NULL, NULL);
@@ -105,6 +153,15 @@ static void wndSettings_select_callback(MenuLayer* menu_layer, MenuIndex* cell_i
 
       break;
     }
+    case MNU_ITEM_ROLLUP: {
+      rollupPeriod = (rollupPeriod + 1) % LAST_ROLLUP_PERIOD;
+      menu_layer_reload_data(menu_layer);
+      break;
+    }
+    case MNU_ITEM_HISTORY: {
+      wndHistory_push();
+      break;
+    }
 #if 0
     case MNU_ITEM_ACKNOWLEDGEMENTS: {
       break;
@@ -150,8 +207,9 @@ void wndSettings_setPalette(const MPA_Palette pal) {
 
 /////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////
-void wndSettings_updateData(const Model* model) {
+void wndSettings_updateData(const Model* model, const Model_FieldMask changed) {
   dataModel = model;
+  if (!(changed & MODEL_FIELD_BIT(MODEL_FIELD_STATUS))) return;
   MagPebApp_ErrCode mpaRet = MPA_SUCCESS;
 
   if ( (mpaRet = Model_getStatus(dataModel, &mtgStatus)) != MPA_SUCCESS) {
@@ -248,6 +306,8 @@ void wndSettings_create() {
 
   if (!strxcpy(statusMsg, STATUS_MSG_SZ, "Please Wait...", NULL)) { return; }
 
+  wndHistory_create();
+
   // Set handlers to manage the elements inside the Window
   window_set_window_handlers(wndSettings, (WindowHandlers) {
     .load =   wndSettings_load,
@@ -263,6 +323,7 @@ void wndSettings_destroy() {
   if (!wndSettings) {
     APP_LOG(APP_LOG_LEVEL_WARNING, "Attempting to destroy a null pointer!");
   } else {
+    wndHistory_destroy();
     window_destroy(wndSettings);
     wndSettings = NULL;
   }
@@ -2,6 +2,7 @@
 #include <pebble.h>
 
 #include "../data/Model.h"
+#include "../data/Rollup.h"
 
 // ToggleMeetingHandler is a pointer to a function that takes no
 // parameter and returns nothing.
@@ -11,10 +12,16 @@ typedef void (*ToggleMeetingHandler)(void);
 // parameter and returns nothing.
 typedef void (*ResetMeetingHandler)(void);
 
+// GetRollupHandler is a pointer to a function that takes three parameters
+// (the period; bucket pointer, for the totals of the current one; string
+// pointer, for the currency they are in) and returns whether it succeeded.
+typedef bool (*GetRollupHandler)(const Rollup_Period, Rollup_Bucket*, const char**);
+
 // wndSettingsHandlers is a struct that contains the values of the handlers.
 typedef struct wndSettingsHandlers {
   ToggleMeetingHandler toggleMeeting;   ///< Function that this View calls to request actions from its Controller.
   ResetMeetingHandler resetMeeting;     ///< Function that this View calls to request actions from its Controller.
+  GetRollupHandler getRollup;           ///< Function that this View calls to get data from its Controller.
 } wndSettingsHandlers;
 
 
@@ -22,7 +29,7 @@ void wndSettings_setHandlers(const wndSettingsHandlers);
 void wndSettings_setPalette(const MPA_Palette);
 
 void wndSettings_updateClock(struct tm*);
-void wndSettings_updateData(const Model*);
+void wndSettings_updateData(const Model*, const Model_FieldMask);
 void wndSettings_create();
 void wndSettings_push();
 void wndSettings_createPush();
@@ -47,6 +47,16 @@ module.exports = [
         "min": 10,
         "max": 200,
         "step": 10
+      },
+      {
+        "type": "slider",
+        "messageKey": "BUDGET_STEP",
+        "defaultValue": 0,
+        "label": "Budget Alarm",
+        "description": "Vibrate each time the meeting cost passes another multiple of this amount; eg. 500 = at $500, $1,000, ... (0 = off)",
+        "min": 0,
+        "max": 5000,
+        "step": 100
       }
     ]
   },
@@ -27,6 +27,42 @@ var xhrRequest = function (method, url, callback) {
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+/// Reads a little-endian unsigned integer of the given width (in bytes)
+/// from a byte array. Values above 2^53 lose precision.
+/////////////////////////////////////////////////////////////////////////////
+var readUint = function (bytes, offset, width) {
+  var value = 0;
+  for (var idx = width - 1; idx >= 0; idx--) {
+    value = (value * 256) + (bytes[offset + idx] & 0xFF);
+  }
+  return value;
+};
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Decodes a binary Model snapshot (see Model_packSnapshot in Model.c).
+/// Returns null if the snapshot version is not understood.
+/////////////////////////////////////////////////////////////////////////////
+var decodeModelSnapshot = function (bytes) {
+  if (!bytes || bytes.length < 32 || bytes[0] !== 1) {
+    return null;
+  }
+  return {
+    version: bytes[0],
+    status: bytes[1],
+    numAttendees: readUint(bytes, 2, 2),
+    totalMilliHourly: readUint(bytes, 4, 4),
+    lastRateChangeTS: readUint(bytes, 8, 4),
+    lastRateMilliCost: readUint(bytes, 12, 8),
+    totalMeetingMilliCost: readUint(bytes, 20, 8),
+    snapshotTS: readUint(bytes, 28, 4)
+  };
+};
+
+
+
 /////////////////////////////////////////////////////////////////////////////
 /// Listen for when an AppMessage is received.
 /////////////////////////////////////////////////////////////////////////////
@@ -38,6 +74,13 @@ Pebble.addEventListener('appmessage',
     if ('GET_CURRENCY_SYMBOL' in dict) {
       var currSym = dict.GET_CURRENCY_SYMBOL;
       console.log("Got currency symbol (" + currSym + ").");
+    } else if ('MODEL_SNAPSHOT' in dict) {
+      var snapshot = decodeModelSnapshot(dict.MODEL_SNAPSHOT);
+      if (snapshot === null) {
+        console.log("Unsupported model snapshot.");
+      } else {
+        console.log("Got model snapshot: " + JSON.stringify(snapshot));
+      }
     } else {
       console.log("Unrecognized app message: " + JSON.stringify(dict));
     }
@@ -0,0 +1,77 @@
+#include <pebble.h>
+#include "bench.h"
+
+#include "data/History_Internal.h"
+#include "data/HistoryCodec.h"
+
+#define NUM_MEETINGS 1000
+#define ROUNDS 2000u
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// A working year of meetings: a few a day on weekdays, of typical length,
+/// size and rate, in one currency.
+/////////////////////////////////////////////////////////////////////////////
+static void makeYear(History_Record* records, const size_t count) {
+  srand(20261018);
+  uint32_t startTS = 1500000000;
+  for (size_t idx=0; idx<count; idx++) {
+    startTS += (rand() % 4 == 0) ? 86400 + rand() % 7200 : 1800 + rand() % 10800;
+    History_Record* record = &records[idx];
+    memset(record, 0, sizeof(*record));
+    record->startTS = startTS;
+    record->durationSecs = 900 + (rand() % 12) * 300 + rand() % 120;
+    record->peakAttendees = 2 + rand() % 10;
+    record->milliCost = 19230ull * record->peakAttendees * record->durationSecs / 3600;
+    strcpy(record->currencySymbol, "$");
+  }
+}
+
+
+int main() {
+  static History_Record records[NUM_MEETINGS];
+  static uint8_t buf[NUM_MEETINGS * HISTORYCODEC_MAX_RECORD_SZ];
+  makeYear(records, NUM_MEETINGS);
+
+  // Size: one run per block, as History stores them
+  size_t used = 0, numBlocks = 1, blockUsed = 0;
+  for (size_t idx=0; idx<NUM_MEETINGS; idx++) {
+    size_t length = 0;
+    const History_Record* prev = (blockUsed == 0) ? NULL : &records[idx-1];
+    HistoryCodec_encode(prev, &records[idx], buf + used, sizeof(buf) - used, &length);
+    if (blockUsed + length > HISTORY_BLOCK_DATA_SZ) {
+      numBlocks++;
+      blockUsed = 0;
+      HistoryCodec_encode(NULL, &records[idx], buf + used, sizeof(buf) - used, &length);
+    }
+    blockUsed += length;
+    used += length;
+  }
+  printf("%-44s %10.2f bytes/record (%zu raw) %6.1f records/block\n", "HistoryCodec size",
+         (double)used / NUM_MEETINGS, sizeof(History_Record), (double)NUM_MEETINGS / numBlocks);
+
+  // Speed: one long run
+  Bench bench = bench_start("HistoryCodec_encode");
+  for (uint32_t round=0; round<ROUNDS; round++) {
+    used = 0;
+    for (size_t idx=0; idx<NUM_MEETINGS; idx++) {
+      size_t length = 0;
+      HistoryCodec_encode((idx == 0) ? NULL : &records[idx-1], &records[idx], buf + used, sizeof(buf) - used, &length);
+      used += length;
+    }
+    benchSink += used;
+  }
+  bench_stop(&bench, (uint64_t)ROUNDS * NUM_MEETINGS);
+
+  History_Record decoded;
+  bench = bench_start("HistoryCodec_decodeNext");
+  for (uint32_t round=0; round<ROUNDS; round++) {
+    HistoryCodec_Decoder decoder;
+    HistoryCodec_startDecode(&decoder, buf, used);
+    while (HistoryCodec_decodeNext(&decoder, &decoded) == MPA_SUCCESS) { }
+    benchSink += decoded.milliCost;
+  }
+  bench_stop(&bench, (uint64_t)ROUNDS * NUM_MEETINGS);
+
+  return 0;
+}
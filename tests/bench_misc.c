@@ -0,0 +1,41 @@
+#include <pebble.h>
+#include "bench.h"
+
+#include "misc.h"
+
+#define OPS 20000000u
+
+int main() {
+  uint64_t acc64 = 0;
+  uint32_t acc32 = 0;
+
+  Bench bench = bench_start("u64add_u64_u64");
+  for (uint32_t idx=0; idx<OPS; idx++) {
+    u64add_u64_u64(&acc64, acc64, idx);
+  }
+  bench_stop(&bench, OPS);
+  benchSink = acc64;
+
+  bench = bench_start("u64mult_u64_u32 (32-bit multiplicand)");
+  for (uint32_t idx=0; idx<OPS; idx++) {
+    u64mult_u64_u32(&acc64, idx, 19230);
+    benchSink += acc64;
+  }
+  bench_stop(&bench, OPS);
+
+  bench = bench_start("u64mult_u64_u32 (64-bit multiplicand)");
+  for (uint32_t idx=0; idx<OPS; idx++) {
+    u64mult_u64_u32(&acc64, ((uint64_t)1 << 33) + idx, 3600);
+    benchSink += acc64;
+  }
+  bench_stop(&bench, OPS);
+
+  bench = bench_start("u32mult_u32_u32");
+  for (uint32_t idx=0; idx<OPS; idx++) {
+    u32mult_u32_u32(&acc32, idx & 0xFFFF, 19230);
+    benchSink += acc32;
+  }
+  bench_stop(&bench, OPS);
+
+  return 0;
+}
@@ -0,0 +1,101 @@
+#include <pebble.h>
+#include "bench.h"
+#include "pebble_host.h"
+
+#include "data/Model_Internal.h"
+
+#define OPS 20000000u
+#define T0 1500000000
+
+#define MEETING_SECS (8 * 3600)
+#define CADENCE_PASSES 200
+
+static time_t wakeTS[MEETING_SECS];
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Times the Model's share of the view update, at the cadence the app
+/// actually wakes up for one: the next visible change in the cost or the
+/// next minute, whichever comes first (see comm_scheduleUpdate).
+/////////////////////////////////////////////////////////////////////////////
+static void bench_updateCadence(const int16_t attendees, const uint32_t milliHourly) {
+  host_setTime(T0, 0);
+  Model* model = Model_create();
+  Model_adjustAttendance(model, attendees, milliHourly);
+  Model_Checkpoint start;
+  Model_getCheckpoint(model, &start);
+
+  // Work out when the app would wake up over the meeting.
+  size_t numWakes = 0;
+  time_t now = T0;
+  while (now < T0 + MEETING_SECS) {
+    time_t nextTS = now - (now % 60) + 60, changeTS = 0;
+    Model_getNextVisibleChange(model, &changeTS);
+    if ( (changeTS != 0) && (changeTS < nextTS) ) nextTS = changeTS;
+    now = wakeTS[numWakes++] = nextTS;
+    host_setTime(now, 0);
+    Model_updateTime(model, NULL, SECOND_UNIT);
+  }
+
+  char name[64];
+  snprintf(name, sizeof(name), "view update, %d x %lu.%03lu/h (%zu wakes)", attendees,
+           (unsigned long)(milliHourly / 1000), (unsigned long)(milliHourly % 1000), numWakes);
+  Bench bench = bench_start(name);
+  for (int pass=0; pass<CADENCE_PASSES; pass++) {
+    host_setTime(T0, 0);
+    Model_restoreCheckpoint(model, &start);
+    for (size_t idx=0; idx<numWakes; idx++) {
+      time_t changeTS = 0;
+      host_setTime(wakeTS[idx], 0);
+      Model_updateTime(model, NULL, SECOND_UNIT);
+      Model_getNextVisibleChange(model, &changeTS);
+      benchSink += changeTS;
+    }
+  }
+  bench_stop(&bench, (uint64_t)CADENCE_PASSES * numWakes);
+  Model_destroy(model);
+}
+
+
+int main() {
+  host_setTime(T0, 0);
+  Model* model = Model_create();
+  Model_adjustAttendance(model, 5, 0);
+
+  // One second passes between calls, as with a per-second tick.
+  Bench bench = bench_start("Model_calculateCost (1 s apart)");
+  for (uint32_t idx=1; idx<=OPS; idx++) {
+    host_setTime(T0 + idx, 0);
+    Model_calculateCost(model);
+  }
+  bench_stop(&bench, OPS);
+
+  // Several seconds pass between calls (missed ticks).
+  Model_destroy(model);
+  host_setTime(T0, 0);
+  model = Model_create();
+  Model_adjustAttendance(model, 5, 0);
+  bench = bench_start("Model_calculateCost (7 s apart)");
+  for (uint32_t idx=1; idx<=OPS; idx++) {
+    host_setTime(T0 + 7 * idx, 0);
+    Model_calculateCost(model);
+  }
+  bench_stop(&bench, OPS);
+
+  char fmtd[FMTD_COST_SZ];
+  bench = bench_start("Model_getFmtdMeetingCost");
+  for (uint32_t idx=0; idx<OPS / 10; idx++) {
+    Model_getFmtdMeetingCost(model, fmtd, sizeof(fmtd));
+    benchSink += (uint8_t)fmtd[1];
+  }
+  bench_stop(&bench, OPS / 10);
+  Model_destroy(model);
+
+  // calculate + next visible change, per wake-up over an 8-hour meeting
+  bench_updateCadence(1, 9615);
+  bench_updateCadence(1, 19230);
+  bench_updateCadence(5, 19230);
+  bench_updateCadence(40, 50000);
+
+  return 0;
+}
@@ -0,0 +1,39 @@
+#include <pebble.h>
+#include "bench.h"
+
+#include "libs/SlotQueue.h"
+
+#define OPS 20000000u
+#define SLOT_SZ 40
+
+int main() {
+  SlotQueue* queue = SlotQueue_create(8, SLOT_SZ);
+  void* slot = NULL;
+
+  Bench bench = bench_start("SlotQueue write + drop");
+  for (uint32_t idx=0; idx<OPS; idx++) {
+    SlotQueue_write(queue, SLOTQUEUE_REJECT_NEW, &slot, NULL);
+    ((uint8_t*)slot)[0] = (uint8_t)idx;
+    SlotQueue_drop(queue);
+  }
+  bench_stop(&bench, OPS);
+
+  // A full queue that drops its oldest slot on every write
+  for (int idx=0; idx<8; idx++) SlotQueue_write(queue, SLOTQUEUE_REJECT_NEW, &slot, NULL);
+  bench = bench_start("SlotQueue write (full, drop oldest)");
+  for (uint32_t idx=0; idx<OPS; idx++) {
+    SlotQueue_write(queue, SLOTQUEUE_DROP_OLDEST, &slot, NULL);
+    ((uint8_t*)slot)[0] = (uint8_t)idx;
+  }
+  bench_stop(&bench, OPS);
+
+  bench = bench_start("SlotQueue peekAt (8 slots)");
+  for (uint32_t idx=0; idx<OPS; idx++) {
+    SlotQueue_peekAt(queue, idx & 7, &slot);
+    benchSink += ((uint8_t*)slot)[0];
+  }
+  bench_stop(&bench, OPS);
+
+  SlotQueue_destroy(queue);
+  return 0;
+}
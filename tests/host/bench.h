@@ -0,0 +1,38 @@
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "libs/magpebapp.h"
+
+// Minimal microbenchmark helpers. A benchmark runs an operation many times
+// and reports the mean time and heap allocations per operation.
+
+// Keeps results alive so the compiler can't optimize the work away.
+static volatile uint64_t benchSink;
+
+static inline uint64_t bench_nowNs(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+typedef struct Bench {
+  const char* name;
+  uint64_t    startNs;
+  uint32_t    startAllocs;
+} Bench;
+
+static inline Bench bench_start(const char* name) {
+  Bench bench = { name, 0, MagPebApp_getAllocCount() };
+  bench.startNs = bench_nowNs();
+  return bench;
+}
+
+static inline double bench_stop(const Bench* bench, const uint64_t ops) {
+  uint64_t elapsedNs = bench_nowNs() - bench->startNs;
+  uint32_t allocs = MagPebApp_getAllocCount() - bench->startAllocs;
+  double nsPerOp = (double)elapsedNs / (double)ops;
+  printf("%-44s %10.2f ns/op %8.3f allocs/op\n", bench->name, nsPerOp, (double)allocs / (double)ops);
+  return nsPerOp;
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <inttypes.h>
+#include <stdio.h>
+
+// Minimal assertions for the host tests. A failed check is reported and
+// counted, and the test carries on; CHECK_DONE() makes the exit status.
+
+static unsigned checkFailures = 0;
+static unsigned checkCount = 0;
+
+#define CHECK(cond) do {                                                      \
+    checkCount++;                                                             \
+    if (!(cond)) {                                                            \
+      checkFailures++;                                                        \
+      fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+    }                                                                         \
+  } while (0)
+
+#define CHECK_EQ_U64(actual, expected) do {                                   \
+    uint64_t chkActual = (uint64_t)(actual), chkExpected = (uint64_t)(expected); \
+    checkCount++;                                                             \
+    if (chkActual != chkExpected) {                                           \
+      checkFailures++;                                                        \
+      fprintf(stderr, "%s:%d: CHECK failed: %s == %" PRIu64 ", expected %" PRIu64 "\n", \
+              __FILE__, __LINE__, #actual, chkActual, chkExpected);           \
+    }                                                                         \
+  } while (0)
+
+#define CHECK_DONE() (                                                        \
+    printf("%s: %u checks, %u failed\n", __FILE__, checkCount, checkFailures), \
+    (checkFailures == 0) ? 0 : 1)
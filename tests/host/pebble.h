@@ -0,0 +1,77 @@
+#pragma once
+
+/////////////////////////////////////////////////////////////////////////////
+/// Host stand-in for the Pebble SDK header. It declares just enough of the
+/// SDK for the platform-independent code (src/c/data, src/c/libs and
+/// src/c/misc.c) to build and run on Linux. The functions are implemented
+/// in pebble_host.c; the tests drive them through pebble_host.h.
+/////////////////////////////////////////////////////////////////////////////
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+
+// Logging
+enum {
+  APP_LOG_LEVEL_ERROR = 1,
+  APP_LOG_LEVEL_WARNING = 50,
+  APP_LOG_LEVEL_INFO = 100,
+  APP_LOG_LEVEL_DEBUG = 200,
+  APP_LOG_LEVEL_DEBUG_VERBOSE = 255,
+};
+// As in the SDK, so the formats are checked; the host drops the output.
+void app_log(uint8_t log_level, const char* src_filename, int src_line_number, const char* fmt, ...)
+  __attribute__((format(printf, 4, 5)));
+#define APP_LOG(level, fmt, args...)  app_log(level, __FILE__, __LINE__, fmt, ## args)
+
+
+// Misc
+#define ARRAY_LENGTH(array) (sizeof((array))/sizeof((array)[0]))
+#define PBL_IF_ROUND_ELSE(if_true, if_false) (if_false)
+#define PBL_IF_COLOR_ELSE(if_true, if_false) (if_true)
+
+typedef int32_t status_t;
+#define S_SUCCESS 0
+#define E_DOES_NOT_EXIST -10
+#define E_RANGE -6
+
+
+// Graphics types (only the ones that appear in shared headers)
+typedef union GColor8 { uint8_t argb; } GColor8;
+typedef GColor8 GColor;
+#define GColorBlack ((GColor8){.argb = 0xC0})
+#define GColorWhite ((GColor8){.argb = 0xFF})
+
+
+// Time
+typedef enum {
+  SECOND_UNIT = 1 << 0,
+  MINUTE_UNIT = 1 << 1,
+  HOUR_UNIT   = 1 << 2,
+  DAY_UNIT    = 1 << 3,
+  MONTH_UNIT  = 1 << 4,
+  YEAR_UNIT   = 1 << 5,
+} TimeUnits;
+
+uint16_t time_ms(time_t* tloc, uint16_t* out_ms);
+
+
+// Locale
+const char* i18n_get_system_locale(void);
+
+
+// Persistent storage (kept in memory)
+#define PERSIST_DATA_MAX_LENGTH 256
+#define PERSIST_STRING_MAX_LENGTH PERSIST_DATA_MAX_LENGTH
+
+bool persist_exists(const uint32_t key);
+int persist_get_size(const uint32_t key);
+int persist_read_data(const uint32_t key, void* buffer, const size_t buffer_size);
+status_t persist_write_data(const uint32_t key, const void* data, const size_t size);
+status_t persist_delete(const uint32_t key);
+
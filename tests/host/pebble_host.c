@@ -0,0 +1,132 @@
+#include <pebble.h>
+#include "pebble_host.h"
+
+// JRB NOTE: Persistent storage is a small table of keys, like the watch's:
+// each value is at most PERSIST_DATA_MAX_LENGTH bytes.
+#define HOST_PERSIST_MAX_KEYS 64
+
+typedef struct HostPersistEntry {
+  bool     used;
+  uint32_t key;
+  size_t   size;
+  uint8_t  data[PERSIST_DATA_MAX_LENGTH];
+} HostPersistEntry;
+
+static time_t hostSecs = 1500000000;
+static uint16_t hostMs = 0;
+static const char* hostLocale = "en_US";
+
+static HostPersistEntry persistEntries[HOST_PERSIST_MAX_KEYS];
+static bool persistWritesFail = false;
+static int32_t persistWritesLeft = -1;     ///< writes to let through before failing; -1 for all
+static uint32_t persistWrites = 0;
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Time
+/////////////////////////////////////////////////////////////////////////////
+void host_setTime(const time_t secs, const uint16_t ms) {
+  hostSecs = secs;
+  hostMs = ms;
+}
+
+void host_advanceTime(const uint32_t secs) {
+  hostSecs += secs;
+}
+
+uint16_t time_ms(time_t* tloc, uint16_t* out_ms) {
+  if (tloc != NULL) *tloc = hostSecs;
+  if (out_ms != NULL) *out_ms = hostMs;
+  return hostMs;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Locale
+/////////////////////////////////////////////////////////////////////////////
+void host_setLocale(const char* locale) {
+  hostLocale = locale;
+}
+
+const char* i18n_get_system_locale(void) {
+  return hostLocale;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Logging
+/////////////////////////////////////////////////////////////////////////////
+void app_log(uint8_t log_level, const char* src_filename, int src_line_number, const char* fmt, ...) {
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Persistent storage
+/////////////////////////////////////////////////////////////////////////////
+static HostPersistEntry* host_findPersist(const uint32_t key) {
+  for (size_t idx=0; idx<HOST_PERSIST_MAX_KEYS; idx++) {
+    if (persistEntries[idx].used && (persistEntries[idx].key == key)) return &persistEntries[idx];
+  }
+  return NULL;
+}
+
+void host_clearPersist(void) {
+  memset(persistEntries, 0, sizeof(persistEntries));
+}
+
+void host_failPersistWrites(const bool fail) {
+  persistWritesFail = fail;
+  persistWritesLeft = -1;
+}
+
+void host_failPersistWritesAfter(const uint32_t count) {
+  persistWritesFail = false;
+  persistWritesLeft = (int32_t)count;
+}
+
+uint32_t host_getPersistWrites(void) {
+  return persistWrites;
+}
+
+bool persist_exists(const uint32_t key) {
+  return host_findPersist(key) != NULL;
+}
+
+int persist_get_size(const uint32_t key) {
+  HostPersistEntry* entry = host_findPersist(key);
+  return (entry != NULL) ? (int)entry->size : E_DOES_NOT_EXIST;
+}
+
+int persist_read_data(const uint32_t key, void* buffer, const size_t buffer_size) {
+  HostPersistEntry* entry = host_findPersist(key);
+  if (entry == NULL) return E_DOES_NOT_EXIST;
+  size_t size = (entry->size < buffer_size) ? entry->size : buffer_size;
+  memcpy(buffer, entry->data, size);
+  return (int)size;
+}
+
+status_t persist_write_data(const uint32_t key, const void* data, const size_t size) {
+  if (persistWritesLeft == 0) persistWritesFail = true;
+  if (persistWritesFail || (size > PERSIST_DATA_MAX_LENGTH)) return E_RANGE;
+  if (persistWritesLeft > 0) persistWritesLeft--;
+
+  HostPersistEntry* entry = host_findPersist(key);
+  for (size_t idx=0; (entry == NULL) && (idx<HOST_PERSIST_MAX_KEYS); idx++) {
+    if (!persistEntries[idx].used) entry = &persistEntries[idx];
+  }
+  if (entry == NULL) return E_RANGE;
+
+  entry->used = true;
+  entry->key = key;
+  entry->size = size;
+  memcpy(entry->data, data, size);
+  persistWrites++;
+  return (status_t)size;
+}
+
+status_t persist_delete(const uint32_t key) {
+  HostPersistEntry* entry = host_findPersist(key);
+  if (entry == NULL) return E_DOES_NOT_EXIST;
+  entry->used = false;
+  return S_SUCCESS;
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include <pebble.h>
+
+// Controls for the host stand-ins in pebble_host.c
+
+// Sets the time that time_ms() reports.
+void host_setTime(const time_t secs, const uint16_t ms);
+// Moves the time that time_ms() reports forward.
+void host_advanceTime(const uint32_t secs);
+
+// Sets the locale that i18n_get_system_locale() reports.
+void host_setLocale(const char* locale);
+
+// Forgets everything in persistent storage.
+void host_clearPersist(void);
+// Makes persist writes fail (with E_RANGE) while set.
+void host_failPersistWrites(const bool fail);
+// Lets the next count persist writes through, then fails the rest, until
+// host_failPersistWrites(false).
+void host_failPersistWritesAfter(const uint32_t count);
+// Counts persist writes since launch.
+uint32_t host_getPersistWrites(void);
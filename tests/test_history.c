@@ -0,0 +1,132 @@
+#include <pebble.h>
+#include "check.h"
+#include "pebble_host.h"
+
+#include "data/History.h"
+
+// Enough meetings to go round the ring of blocks more than once (a block
+// holds a few dozen of them)
+#define NUM_MEETINGS (HISTORY_NUM_BLOCKS * 100)
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// The nth meeting appended.
+/////////////////////////////////////////////////////////////////////////////
+static History_Record meeting(const uint32_t nth) {
+  History_Record record;
+  memset(&record, 0, sizeof(record));
+  record.startTS = 1500000000 + nth * 86400 + (nth % 7) * 1237;
+  record.durationSecs = 900 + (nth % 5) * 611;
+  record.peakAttendees = 1 + nth % 13;
+  record.milliCost = 9615ull * record.peakAttendees * record.durationSecs / 3600;
+  strcpy(record.currencySymbol, "$");
+  return record;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Whether the newest meeting in the history is the nth one appended.
+/////////////////////////////////////////////////////////////////////////////
+static bool newestIs(const History* history, const uint32_t nth) {
+  History_Record newest, expected = meeting(nth);
+  return (History_getRecord(history, 0, &newest) == MPA_SUCCESS) && (memcmp(&newest, &expected, sizeof(newest)) == 0);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Meetings read back newest first, across blocks, and after a relaunch.
+/////////////////////////////////////////////////////////////////////////////
+static void test_appendAndRead() {
+  host_clearPersist();
+  History* history = History_create();
+  for (uint32_t nth=0; nth<30; nth++) {
+    History_Record record = meeting(nth);
+    CHECK(History_append(history, &record) == MPA_SUCCESS);
+  }
+  History_destroy(history);
+
+  history = History_create();
+  size_t count = 0;
+  History_count(history, &count);
+  CHECK_EQ_U64(count, 30);
+  for (size_t idx=0; idx<count; idx++) {
+    History_Record record, expected = meeting(29 - idx);
+    CHECK(History_getRecord(history, idx, &record) == MPA_SUCCESS);
+    CHECK(memcmp(&record, &expected, sizeof(record)) == 0);
+  }
+  History_destroy(history);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Finds the appends that move the head onto a recycled block: those that
+/// write the header as well as the block, once the ring is full.
+/// @return  the number found, up to max
+/////////////////////////////////////////////////////////////////////////////
+static size_t findRecyclingAppends(uint32_t* found, const size_t max) {
+  size_t numFound = 0, numMoves = 0;
+  host_clearPersist();
+  History* history = History_create();
+  for (uint32_t nth=0; (nth<NUM_MEETINGS) && (numFound<max); nth++) {
+    History_Record record = meeting(nth);
+    uint32_t writesBefore = host_getPersistWrites();
+    History_append(history, &record);
+    if ( (nth > 0) && (host_getPersistWrites() - writesBefore == 2) && (++numMoves >= HISTORY_NUM_BLOCKS) ) {
+      found[numFound++] = nth;
+    }
+  }
+  History_destroy(history);
+  return numFound;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// A failed append onto a recycled block leaves the history as it was:
+/// the overwritten meetings don't come back as the newest, whether the
+/// first write failed or only the second.
+/////////////////////////////////////////////////////////////////////////////
+static void test_failedRecycle() {
+  uint32_t recycling[2];
+  CHECK_EQ_U64(findRecyclingAppends(recycling, ARRAY_LENGTH(recycling)), ARRAY_LENGTH(recycling));
+
+  for (uint32_t writesLetThrough=0; writesLetThrough<2; writesLetThrough++) {
+    uint32_t failAt = recycling[writesLetThrough];
+    host_clearPersist();
+    History* history = History_create();
+    for (uint32_t nth=0; nth<failAt; nth++) {
+      History_Record record = meeting(nth);
+      History_append(history, &record);
+    }
+    size_t countBefore = 0;
+    History_count(history, &countBefore);
+
+    History_Record record = meeting(failAt);
+    host_failPersistWritesAfter(writesLetThrough);
+    CHECK(History_append(history, &record) == MPA_UNKNOWN_ERR);
+    host_failPersistWrites(false);
+    CHECK(newestIs(history, failAt - 1));
+
+    // As read back after a relaunch
+    History* relaunched = History_create();
+    CHECK(newestIs(relaunched, failAt - 1));
+    size_t count = 0;
+    History_count(relaunched, &count);
+    CHECK(count <= countBefore);
+    History_destroy(relaunched);
+
+    // The next append goes through.
+    CHECK(History_append(history, &record) == MPA_SUCCESS);
+    CHECK(newestIs(history, failAt));
+    History_destroy(history);
+    relaunched = History_create();
+    CHECK(newestIs(relaunched, failAt));
+    History_destroy(relaunched);
+  }
+}
+
+
+int main() {
+  test_appendAndRead();
+  test_failedRecycle();
+  return CHECK_DONE();
+}
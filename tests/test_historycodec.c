@@ -0,0 +1,291 @@
+#include <pebble.h>
+#include "check.h"
+
+#include "data/HistoryCodec.h"
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Fills in a record.
+/////////////////////////////////////////////////////////////////////////////
+static History_Record makeRecord(const uint32_t startTS, const uint32_t durationSecs, const uint16_t peakAttendees, const uint64_t milliCost, const char* currencySymbol) {
+  History_Record record;
+  memset(&record, 0, sizeof(record));
+  record.startTS = startTS;
+  record.durationSecs = durationSecs;
+  record.peakAttendees = peakAttendees;
+  record.milliCost = milliCost;
+  strncpy(record.currencySymbol, currencySymbol, sizeof(record.currencySymbol) - 1);
+  return record;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Encodes records as one run.
+/// @return  the length of the run, in bytes
+/////////////////////////////////////////////////////////////////////////////
+static size_t encodeRun(const History_Record* records, const size_t count, uint8_t* buf, const size_t bufsize) {
+  size_t used = 0;
+  for (size_t idx=0; idx<count; idx++) {
+    size_t length = 0;
+    CHECK(HistoryCodec_encode((idx == 0) ? NULL : &records[idx-1], &records[idx], buf + used, bufsize - used, &length) == MPA_SUCCESS);
+    used += length;
+  }
+  return used;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Writes a varint, for building runs by hand.
+/// @return  the byte after it
+/////////////////////////////////////////////////////////////////////////////
+static uint8_t* putVarint(uint8_t* cursor, uint64_t value) {
+  while (value >= 0x80) {
+    *cursor++ = (uint8_t)(value | 0x80);
+    value >>= 7;
+  }
+  *cursor++ = (uint8_t)value;
+  return cursor;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Decodes a whole run and checks it against the records encoded.
+/////////////////////////////////////////////////////////////////////////////
+static void checkRun(const History_Record* records, const size_t count, const uint8_t* buf, const size_t used) {
+  HistoryCodec_Decoder decoder;
+  CHECK(HistoryCodec_startDecode(&decoder, buf, used) == MPA_SUCCESS);
+  for (size_t idx=0; idx<count; idx++) {
+    History_Record decoded;
+    CHECK(HistoryCodec_decodeNext(&decoder, &decoded) == MPA_SUCCESS);
+    CHECK(memcmp(&decoded, &records[idx], sizeof(decoded)) == 0);
+  }
+  CHECK(HistoryCodec_decodeNext(&decoder, NULL) == MPA_EMPTY_ERR);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Decodes the first record of a hand-built run.
+/////////////////////////////////////////////////////////////////////////////
+static MagPebApp_ErrCode decodeFirst(const uint8_t* buf, const size_t used, History_Record* record) {
+  HistoryCodec_Decoder decoder;
+  HistoryCodec_startDecode(&decoder, buf, used);
+  return HistoryCodec_decodeNext(&decoder, record);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Builds a first record by hand, with any value in each field.
+/// @return  the length of the record, in bytes
+/////////////////////////////////////////////////////////////////////////////
+static size_t buildRecord(uint8_t* buf, const uint64_t zigzag, const uint64_t durationSecs, const uint64_t attendeesFlag, const uint64_t milliCost) {
+  uint8_t* cursor = buf;
+  cursor = putVarint(cursor, zigzag);
+  cursor = putVarint(cursor, durationSecs);
+  cursor = putVarint(cursor, attendeesFlag);
+  cursor = putVarint(cursor, milliCost);
+  *cursor++ = 1;
+  *cursor++ = '$';
+  return cursor - buf;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Records decode to exactly what was encoded, then the run ends.
+/////////////////////////////////////////////////////////////////////////////
+static void test_roundTrip() {
+  const History_Record records[] = {
+    makeRecord(1500000000, 1800, 4, 38460, "$"),
+    makeRecord(1500003600, 3600, 12, 230760, "$"),
+    makeRecord(1500090000, 900, 2, 9615, "$"),
+  };
+  uint8_t buf[128];
+  size_t used = encodeRun(records, ARRAY_LENGTH(records), buf, sizeof(buf));
+
+  HistoryCodec_Decoder decoder;
+  CHECK(HistoryCodec_startDecode(&decoder, buf, used) == MPA_SUCCESS);
+  for (size_t idx=0; idx<ARRAY_LENGTH(records); idx++) {
+    History_Record decoded;
+    CHECK(HistoryCodec_decodeNext(&decoder, &decoded) == MPA_SUCCESS);
+    CHECK(memcmp(&decoded, &records[idx], sizeof(decoded)) == 0);
+  }
+  CHECK(HistoryCodec_decodeNext(&decoder, NULL) == MPA_EMPTY_ERR);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// A record that doesn't fit is refused, and nothing is written.
+/////////////////////////////////////////////////////////////////////////////
+static void test_encodeFull() {
+  History_Record record = makeRecord(1500000000, 1800, 4, 38460, "$");
+  uint8_t buf[4] = { 0xEE, 0xEE, 0xEE, 0xEE };
+  size_t length = 99;
+  CHECK(HistoryCodec_encode(NULL, &record, buf, sizeof(buf), &length) == MPA_FULL_ERR);
+  CHECK_EQ_U64(length, 99);
+  CHECK_EQ_U64(buf[0], 0xEE);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Every field round-trips at its limits, and the decoder refuses varints
+/// one past them: 35 bits for the zigzagged start delta, 32 for the
+/// duration, 17 for the attendees and flag, and 64 for the cost.
+/////////////////////////////////////////////////////////////////////////////
+static void test_varintLimits() {
+  const History_Record records[] = {
+    makeRecord(UINT32_MAX, UINT32_MAX, UINT16_MAX, UINT64_MAX, "$"),
+    makeRecord(0, 0, 0, 0, "$"),
+    makeRecord(UINT32_MAX, 1, 1, 1, "$"),
+  };
+  uint8_t buf[3 * HISTORYCODEC_MAX_RECORD_SZ];
+  size_t used = encodeRun(records, ARRAY_LENGTH(records), buf, sizeof(buf));
+  checkRun(records, ARRAY_LENGTH(records), buf, used);
+
+  // The largest record fits the documented bound exactly.
+  size_t length = 0;
+  History_Record widest = makeRecord(UINT32_MAX, UINT32_MAX, UINT16_MAX, UINT64_MAX, "1234567");
+  CHECK(HistoryCodec_encode(NULL, &widest, buf, HISTORYCODEC_MAX_RECORD_SZ, &length) == MPA_SUCCESS);
+  CHECK_EQ_U64(length, HISTORYCODEC_MAX_RECORD_SZ);
+
+  History_Record decoded;
+  used = buildRecord(buf, (1ull << 35) - 1, 0, 1, 0);
+  CHECK(decodeFirst(buf, used, &decoded) == MPA_SUCCESS);
+  used = buildRecord(buf, 1ull << 35, 0, 1, 0);
+  CHECK(decodeFirst(buf, used, &decoded) == MPA_INVALID_INPUT_ERR);
+
+  used = buildRecord(buf, 0, UINT32_MAX, 1, 0);
+  CHECK(decodeFirst(buf, used, &decoded) == MPA_SUCCESS);
+  CHECK_EQ_U64(decoded.durationSecs, UINT32_MAX);
+  used = buildRecord(buf, 0, 1ull << 32, 1, 0);
+  CHECK(decodeFirst(buf, used, &decoded) == MPA_INVALID_INPUT_ERR);
+
+  used = buildRecord(buf, 0, 0, (1u << 17) - 1, 0);
+  CHECK(decodeFirst(buf, used, &decoded) == MPA_SUCCESS);
+  CHECK_EQ_U64(decoded.peakAttendees, UINT16_MAX);
+  used = buildRecord(buf, 0, 0, 1u << 17, 0);
+  CHECK(decodeFirst(buf, used, &decoded) == MPA_INVALID_INPUT_ERR);
+
+  used = buildRecord(buf, 0, 0, 1, UINT64_MAX);
+  CHECK(decodeFirst(buf, used, &decoded) == MPA_SUCCESS);
+  CHECK_EQ_U64(decoded.milliCost, UINT64_MAX);
+
+  // A 10-byte varint has room for 70 bits; any past the 64th are refused.
+  uint8_t* cursor = buf;
+  *cursor++ = 0x00;  *cursor++ = 0x00;  *cursor++ = 0x01;
+  for (int idx=0; idx<9; idx++) *cursor++ = 0xFF;
+  *cursor++ = 0x02;
+  *cursor++ = 1;  *cursor++ = '$';
+  CHECK(decodeFirst(buf, cursor - buf, &decoded) == MPA_INVALID_INPUT_ERR);
+
+  // So is an 11th byte.
+  cursor = buf;
+  *cursor++ = 0x00;  *cursor++ = 0x00;  *cursor++ = 0x01;
+  for (int idx=0; idx<10; idx++) *cursor++ = 0x80;
+  *cursor++ = 0x00;
+  *cursor++ = 1;  *cursor++ = '$';
+  CHECK(decodeFirst(buf, cursor - buf, &decoded) == MPA_INVALID_INPUT_ERR);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Meetings recorded out of order encode negative start deltas.
+/////////////////////////////////////////////////////////////////////////////
+static void test_negativeDeltas() {
+  const History_Record records[] = {
+    makeRecord(1500090000, 900, 2, 9615, "$"),
+    makeRecord(1500089999, 900, 2, 9615, "$"),     // -1
+    makeRecord(1500000000, 1800, 4, 38460, "$"),   // -89999
+    makeRecord(1500000000, 1800, 4, 38460, "$"),   // 0
+    makeRecord(0, 60, 1, 320, "$"),                // the whole range back
+  };
+  uint8_t buf[5 * HISTORYCODEC_MAX_RECORD_SZ];
+  size_t used = encodeRun(records, ARRAY_LENGTH(records), buf, sizeof(buf));
+  checkRun(records, ARRAY_LENGTH(records), buf, used);
+
+  // A delta of -1 zigzags to 1: a single byte.
+  size_t length = 0;
+  CHECK(HistoryCodec_encode(&records[0], &records[1], buf, sizeof(buf), &length) == MPA_SUCCESS);
+  CHECK_EQ_U64(buf[0], 1);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// The currency symbol is written only when it changes, and each record
+/// decodes with its own.
+/////////////////////////////////////////////////////////////////////////////
+static void test_currencyChange() {
+  const History_Record records[] = {
+    makeRecord(1500000000, 1800, 4, 38460, "$"),
+    makeRecord(1500003600, 1800, 4, 38460, "€"),
+    makeRecord(1500007200, 1800, 4, 38460, "€"),
+    makeRecord(1500010800, 1800, 4, 38460, "CHF"),
+    makeRecord(1500014400, 1800, 4, 38460, "$"),
+  };
+  uint8_t buf[5 * HISTORYCODEC_MAX_RECORD_SZ];
+  size_t lengths[ARRAY_LENGTH(records)];
+  size_t used = 0;
+  for (size_t idx=0; idx<ARRAY_LENGTH(records); idx++) {
+    CHECK(HistoryCodec_encode((idx == 0) ? NULL : &records[idx-1], &records[idx], buf + used, sizeof(buf) - used, &lengths[idx]) == MPA_SUCCESS);
+    used += lengths[idx];
+  }
+  checkRun(records, ARRAY_LENGTH(records), buf, used);
+
+  // Same fields but the symbol: the changed ones carry its length and bytes.
+  CHECK_EQ_U64(lengths[1], lengths[2] + 1 + strlen("€"));
+  CHECK_EQ_U64(lengths[3], lengths[2] + 1 + strlen("CHF"));
+  CHECK_EQ_U64(lengths[4], lengths[2] + 1 + strlen("$"));
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// A run cut short anywhere gives back the records before the cut, then
+/// either ends cleanly (at a record boundary) or reports it as garbled,
+/// without reading past the end.
+/////////////////////////////////////////////////////////////////////////////
+static void test_truncated() {
+  const History_Record records[] = {
+    makeRecord(1500000000, 1800, 4, 38460, "$"),
+    makeRecord(1500003600, 3600, 12, 230760, "€"),
+    makeRecord(1500090000, 900, 2, UINT64_MAX, "€"),
+  };
+  uint8_t buf[3 * HISTORYCODEC_MAX_RECORD_SZ];
+  size_t ends[ARRAY_LENGTH(records)];
+  size_t used = 0;
+  for (size_t idx=0; idx<ARRAY_LENGTH(records); idx++) {
+    size_t length = 0;
+    HistoryCodec_encode((idx == 0) ? NULL : &records[idx-1], &records[idx], buf + used, sizeof(buf) - used, &length);
+    used += length;
+    ends[idx] = used;
+  }
+
+  for (size_t cut=0; cut<used; cut++) {
+    // Decode from a copy, so nothing past the cut is there to be read.
+    uint8_t* cutBuf = malloc(cut + 1);
+    memcpy(cutBuf, buf, cut);
+
+    size_t whole = 0;
+    while ( (whole < ARRAY_LENGTH(records)) && (ends[whole] <= cut) ) whole++;
+    bool atBoundary = (cut == 0) || (ends[whole - 1] == cut);
+
+    HistoryCodec_Decoder decoder;
+    HistoryCodec_startDecode(&decoder, cutBuf, cut);
+    for (size_t idx=0; idx<whole; idx++) {
+      History_Record decoded;
+      CHECK(HistoryCodec_decodeNext(&decoder, &decoded) == MPA_SUCCESS);
+      CHECK(memcmp(&decoded, &records[idx], sizeof(decoded)) == 0);
+    }
+    CHECK(HistoryCodec_decodeNext(&decoder, NULL) == (atBoundary ? MPA_EMPTY_ERR : MPA_INVALID_INPUT_ERR));
+    CHECK(HistoryCodec_decodeNext(&decoder, NULL) == MPA_EMPTY_ERR);
+    free(cutBuf);
+  }
+}
+
+
+int main() {
+  test_roundTrip();
+  test_encodeFull();
+  test_varintLimits();
+  test_negativeDeltas();
+  test_currencyChange();
+  test_truncated();
+  return CHECK_DONE();
+}
@@ -0,0 +1,243 @@
+#include <pebble.h>
+#include "check.h"
+
+#include "data/Journal.h"
+
+#define T0 1500000000
+
+
+// Segments collected by collectSegment
+typedef struct Breakdown {
+  size_t          count;
+  uint64_t        milliCost;     ///< sum over every segment
+  Journal_Segment segments[16];  ///< the first segments
+} Breakdown;
+
+static bool collectSegment(const Journal_Segment* segment, void* context) {
+  Breakdown* breakdown = (Breakdown*)context;
+  if (breakdown->count < ARRAY_LENGTH(breakdown->segments)) breakdown->segments[breakdown->count] = *segment;
+  breakdown->count++;
+  breakdown->milliCost += segment->milliCost;
+  return true;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// The cost of the journal's meeting at a time, from its tail.
+/////////////////////////////////////////////////////////////////////////////
+static uint64_t tailMilliCost(const Journal* journal, const time_t now) {
+  Journal_Fold tail;
+  uint64_t milliCost = 0;
+  CHECK(Journal_getFold(journal, &tail) == MPA_SUCCESS);
+  CHECK(Journal_getMilliCost(&tail, now, &milliCost) == MPA_SUCCESS);
+  return milliCost;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// The checkpoint's cost plus every segment's is the cost from the tail,
+/// and replaying the entries gives the tail back.
+/////////////////////////////////////////////////////////////////////////////
+static void checkConsistent(const Journal* journal, const time_t now) {
+  Journal_Fold checkpoint, tail, replayed;
+  Breakdown breakdown = { 0 };
+  CHECK(Journal_getCheckpoint(journal, &checkpoint) == MPA_SUCCESS);
+  CHECK(Journal_getFold(journal, &tail) == MPA_SUCCESS);
+  CHECK(Journal_replay(journal, &replayed) == MPA_SUCCESS);
+  CHECK(Journal_forEachSegment(journal, now, collectSegment, &breakdown) == MPA_SUCCESS);
+
+  CHECK_EQ_U64(checkpoint.milliCost + breakdown.milliCost, tailMilliCost(journal, now));
+  CHECK_EQ_U64(replayed.ts, tail.ts);
+  CHECK_EQ_U64(replayed.numAttendees, tail.numAttendees);
+  CHECK_EQ_U64(replayed.totalMilliHourly, tail.totalMilliHourly);
+  CHECK(replayed.running == tail.running);
+  CHECK_EQ_U64(replayed.segmentStartTS, tail.segmentStartTS);
+  CHECK_EQ_U64(replayed.milliCost, tail.milliCost);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+static void test_create() {
+  CHECK(Journal_create(JOURNAL_MAX_EVENT_ENTRIES - 1, NULL) == NULL);
+
+  Journal* journal = Journal_create(4, NULL);
+  CHECK(journal != NULL);
+  size_t count = 99;
+  CHECK(Journal_count(journal, &count) == MPA_SUCCESS);
+  CHECK_EQ_U64(count, 0);
+  CHECK_EQ_U64(tailMilliCost(journal, T0), 0);
+  CHECK(Journal_append(journal, T0, JOURNAL_EVENT_GAP, 0, 0) == MPA_INVALID_INPUT_ERR);
+  CHECK(Journal_append(journal, T0, LAST_JOURNAL_EVENT, 0, 0) == MPA_INVALID_INPUT_ERR);
+  Journal_destroy(journal);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Joins, a pause, a resume and a leave, broken down segment by segment.
+/////////////////////////////////////////////////////////////////////////////
+static void test_segments() {
+  Journal* journal = Journal_create(8, NULL);
+  CHECK(Journal_append(journal, T0, JOURNAL_EVENT_ADJUST, 2, 36000) == MPA_SUCCESS);
+  CHECK(Journal_append(journal, T0 + 100, JOURNAL_EVENT_PAUSE, 0, 0) == MPA_SUCCESS);
+  CHECK(Journal_append(journal, T0 + 200, JOURNAL_EVENT_RESUME, 0, 0) == MPA_SUCCESS);
+  CHECK(Journal_append(journal, T0 + 300, JOURNAL_EVENT_ADJUST, 1, 3600) == MPA_SUCCESS);
+  CHECK(Journal_append(journal, T0 + 400, JOURNAL_EVENT_ADJUST, -2, 36000) == MPA_SUCCESS);
+
+  Breakdown breakdown = { 0 };
+  CHECK(Journal_forEachSegment(journal, T0 + 460, collectSegment, &breakdown) == MPA_SUCCESS);
+  CHECK_EQ_U64(breakdown.count, 4);
+  CHECK_EQ_U64(breakdown.segments[0].startTS, T0);
+  CHECK_EQ_U64(breakdown.segments[0].secs, 100);
+  CHECK_EQ_U64(breakdown.segments[0].numAttendees, 2);
+  CHECK_EQ_U64(breakdown.segments[0].milliCost, 2000);
+  CHECK_EQ_U64(breakdown.segments[1].startTS, T0 + 200);
+  CHECK_EQ_U64(breakdown.segments[1].milliCost, 2000);
+  CHECK_EQ_U64(breakdown.segments[2].numAttendees, 3);
+  CHECK_EQ_U64(breakdown.segments[2].totalMilliHourly, 75600);
+  CHECK_EQ_U64(breakdown.segments[2].milliCost, 2100);
+  // The current segment runs up to now
+  CHECK_EQ_U64(breakdown.segments[3].numAttendees, 1);
+  CHECK_EQ_U64(breakdown.segments[3].secs, 60);
+  CHECK_EQ_U64(breakdown.segments[3].milliCost, 60);
+  CHECK_EQ_U64(tailMilliCost(journal, T0 + 460), 6160);
+  checkConsistent(journal, T0 + 460);
+  Journal_destroy(journal);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Time that doesn't fit in an entry takes one gap entry, however long.
+/////////////////////////////////////////////////////////////////////////////
+static void test_longGap() {
+  Journal* journal = Journal_create(4, NULL);
+  size_t count = 0;
+  Journal_append(journal, T0, JOURNAL_EVENT_ADJUST, 1, 3600);
+  CHECK(Journal_append(journal, T0 + 10 * 86400, JOURNAL_EVENT_PAUSE, 0, 0) == MPA_SUCCESS);
+  Journal_count(journal, &count);
+  CHECK_EQ_U64(count, 3);
+  CHECK_EQ_U64(tailMilliCost(journal, T0 + 20 * 86400), 10 * 86400);
+
+  Journal_Fold tail;
+  Journal_getFold(journal, &tail);
+  CHECK_EQ_U64(tail.ts, T0 + 10 * 86400);
+  checkConsistent(journal, T0 + 20 * 86400);
+  Journal_destroy(journal);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// A full journal folds its oldest entries into the checkpoint, so the
+/// entries held, and replay, stay bounded while the cost stays exact.
+/////////////////////////////////////////////////////////////////////////////
+static void test_foldsWhenFull() {
+  Journal* journal = Journal_create(10, NULL);
+  time_t now = T0;
+  uint64_t refMilliCost = 0;
+  size_t count = 0;
+
+  Journal_append(journal, now, JOURNAL_EVENT_ADJUST, 1, 7200);
+  for (int idx=0; idx<200; idx++) {
+    now += 60 + idx;
+    refMilliCost += (uint64_t)7200 * (60 + idx) / 3600;
+    // An adjustment by no one ends the segment, but keeps the meeting running.
+    bool adjust = (idx % 2);
+    CHECK(Journal_append(journal, now, adjust ? JOURNAL_EVENT_ADJUST : JOURNAL_EVENT_PAUSE, 0, 0) == MPA_SUCCESS);
+    now += 30;
+    if (adjust) refMilliCost += (uint64_t)7200 * 30 / 3600;
+    CHECK(Journal_append(journal, now, JOURNAL_EVENT_RESUME, 0, 0) == MPA_SUCCESS);
+
+    Journal_count(journal, &count);
+    CHECK(count <= 10);
+    CHECK_EQ_U64(tailMilliCost(journal, now), refMilliCost);
+  }
+
+  Journal_Fold checkpoint;
+  Journal_getCheckpoint(journal, &checkpoint);
+  CHECK(checkpoint.milliCost > 0);
+  checkConsistent(journal, now + 45);
+  Journal_destroy(journal);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// An event that can't be folded leaves the journal as it was, even when
+/// it is full.
+/////////////////////////////////////////////////////////////////////////////
+static void test_allOrNothing() {
+  Journal* journal = Journal_create(4, NULL);
+  size_t before = 0, after = 0;
+  Journal_Fold beforeCheckpoint, afterCheckpoint;
+
+  CHECK(Journal_append(journal, T0, JOURNAL_EVENT_ADJUST, -1, 3600) == MPA_OVERFLOW_ERR);
+  Journal_count(journal, &after);
+  CHECK_EQ_U64(after, 0);
+
+  Journal_append(journal, T0, JOURNAL_EVENT_ADJUST, 2, 3600);
+  Journal_append(journal, T0 + 10, JOURNAL_EVENT_PAUSE, 0, 0);
+  Journal_append(journal, T0 + 20, JOURNAL_EVENT_RESUME, 0, 0);
+  Journal_append(journal, T0 + 30, JOURNAL_EVENT_PAUSE, 0, 0);
+  Journal_count(journal, &before);
+  Journal_getCheckpoint(journal, &beforeCheckpoint);
+  CHECK_EQ_U64(before, 4);
+
+  // Three leaving, with a gap before: two entries, neither appended.
+  CHECK(Journal_append(journal, T0 + 100000, JOURNAL_EVENT_ADJUST, -3, 3600) == MPA_OVERFLOW_ERR);
+  Journal_count(journal, &after);
+  Journal_getCheckpoint(journal, &afterCheckpoint);
+  CHECK_EQ_U64(after, before);
+  CHECK_EQ_U64(afterCheckpoint.ts, beforeCheckpoint.ts);
+  CHECK_EQ_U64(tailMilliCost(journal, T0 + 100000), 40);
+  checkConsistent(journal, T0 + 100000);
+  Journal_destroy(journal);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// A reset discards the meeting, and the entries before it.
+/////////////////////////////////////////////////////////////////////////////
+static void test_reset() {
+  Journal* journal = Journal_create(4, NULL);
+  size_t count = 99;
+  Journal_append(journal, T0, JOURNAL_EVENT_ADJUST, 2, 3600);
+  CHECK(Journal_append(journal, T0 + 50, JOURNAL_EVENT_RESET, 0, 0) == MPA_SUCCESS);
+
+  Journal_count(journal, &count);
+  CHECK_EQ_U64(count, 0);
+  CHECK_EQ_U64(tailMilliCost(journal, T0 + 100), 0);
+  Journal_Fold checkpoint;
+  Journal_getCheckpoint(journal, &checkpoint);
+  CHECK_EQ_U64(checkpoint.ts, T0 + 50);
+  CHECK(!checkpoint.running);
+  Journal_destroy(journal);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// A journal restarted from a running meeting carries on from it.
+/////////////////////////////////////////////////////////////////////////////
+static void test_restart() {
+  Journal_Fold start = { .ts = T0, .numAttendees = 1, .totalMilliHourly = 3600, .running = true, .segmentStartTS = T0, .milliCost = 500 };
+  Journal* journal = Journal_create(4, &start);
+  CHECK_EQ_U64(tailMilliCost(journal, T0 + 100), 600);
+
+  Journal_append(journal, T0 + 100, JOURNAL_EVENT_ADJUST, 1, 3600);
+  CHECK_EQ_U64(tailMilliCost(journal, T0 + 200), 800);
+  checkConsistent(journal, T0 + 200);
+
+  CHECK(Journal_restart(journal, NULL) == MPA_SUCCESS);
+  CHECK_EQ_U64(tailMilliCost(journal, T0 + 200), 0);
+  Journal_destroy(journal);
+}
+
+
+int main() {
+  test_create();
+  test_segments();
+  test_longGap();
+  test_foldsWhenFull();
+  test_allOrNothing();
+  test_reset();
+  test_restart();
+  return CHECK_DONE();
+}
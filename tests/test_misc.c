@@ -0,0 +1,85 @@
+#include <pebble.h>
+#include "check.h"
+
+#include "misc.h"
+
+/////////////////////////////////////////////////////////////////////////////
+/// Checked 64-bit addition: exact up to the limit, refused past it.
+/////////////////////////////////////////////////////////////////////////////
+static void test_u64add() {
+  uint64_t sum = 0;
+  CHECK(u64add_u64_u64(&sum, 1, 2) == MPA_SUCCESS);
+  CHECK_EQ_U64(sum, 3);
+
+  CHECK(u64add_u64_u64(&sum, UINT64_MAX - 5, 5) == MPA_SUCCESS);
+  CHECK_EQ_U64(sum, UINT64_MAX);
+
+  sum = 42;
+  CHECK(u64add_u64_u64(&sum, UINT64_MAX - 5, 6) == MPA_OVERFLOW_ERR);
+  CHECK(u64add_u64_u64(&sum, UINT64_MAX, UINT64_MAX) == MPA_OVERFLOW_ERR);
+  CHECK_EQ_U64(sum, 42);    // untouched on overflow
+
+  CHECK(u64add_u64_u64(NULL, 1, 1) == MPA_NULL_POINTER_ERR);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Checked 64x32-bit multiplication: exact up to the limit, refused past it.
+/////////////////////////////////////////////////////////////////////////////
+static void test_u64mult() {
+  uint64_t product = 0;
+  CHECK(u64mult_u64_u32(&product, 0, UINT32_MAX) == MPA_SUCCESS);
+  CHECK_EQ_U64(product, 0);
+
+  CHECK(u64mult_u64_u32(&product, UINT64_MAX, 0) == MPA_SUCCESS);
+  CHECK_EQ_U64(product, 0);
+
+  // Both factors 32-bit: never overflows
+  CHECK(u64mult_u64_u32(&product, UINT32_MAX, UINT32_MAX) == MPA_SUCCESS);
+  CHECK_EQ_U64(product, (uint64_t)UINT32_MAX * UINT32_MAX);
+
+  CHECK(u64mult_u64_u32(&product, UINT64_MAX / 3, 3) == MPA_SUCCESS);
+  CHECK_EQ_U64(product, (UINT64_MAX / 3) * 3);
+
+  product = 42;
+  CHECK(u64mult_u64_u32(&product, UINT64_MAX / 3 + 1, 3) == MPA_OVERFLOW_ERR);
+  CHECK(u64mult_u64_u32(&product, (uint64_t)1 << 33, 1u << 31) == MPA_OVERFLOW_ERR);
+  CHECK_EQ_U64(product, 42);    // untouched on overflow
+
+  CHECK(u64mult_u64_u32(NULL, 1, 1) == MPA_NULL_POINTER_ERR);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// The narrower checked helpers that the Model's attendance math uses.
+/////////////////////////////////////////////////////////////////////////////
+static void test_narrowHelpers() {
+  uint16_t u16 = 0;
+  CHECK(u16add_u16_s16(&u16, 5, -5) == MPA_SUCCESS);
+  CHECK_EQ_U64(u16, 0);
+  CHECK(u16add_u16_s16(&u16, 0, -1) == MPA_OVERFLOW_ERR);
+  CHECK(u16add_u16_s16(&u16, UINT16_MAX, 1) == MPA_OVERFLOW_ERR);
+
+  uint32_t u32 = 0;
+  CHECK(u32add_u32_s32(&u32, 100, -100) == MPA_SUCCESS);
+  CHECK_EQ_U64(u32, 0);
+  CHECK(u32add_u32_s32(&u32, 100, -101) == MPA_OVERFLOW_ERR);
+  CHECK(u32add_u32_u32(&u32, UINT32_MAX, 1) == MPA_OVERFLOW_ERR);
+  CHECK(u32mult_u32_u32(&u32, 65536, 65535) == MPA_SUCCESS);
+  CHECK_EQ_U64(u32, 65536u * 65535u);
+  CHECK(u32mult_u32_u32(&u32, 65536, 65536) == MPA_OVERFLOW_ERR);
+
+  int32_t s32 = 0;
+  CHECK(s32mult_s32_s32(&s32, -19230, 3) == MPA_SUCCESS);
+  CHECK_EQ_U64(s32 == -57690, 1);
+  CHECK(s32mult_s32_s32(&s32, INT32_MAX, 2) == MPA_OVERFLOW_ERR);
+  CHECK(s32mult_s32_s32(&s32, INT32_MIN, -1) == MPA_OVERFLOW_ERR);
+}
+
+
+int main() {
+  test_u64add();
+  test_u64mult();
+  test_narrowHelpers();
+  return CHECK_DONE();
+}
@@ -0,0 +1,296 @@
+#include <pebble.h>
+#include "check.h"
+#include "pebble_host.h"
+
+#include "data/Model.h"
+
+#define T0 1500000000
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Cost of a stretch of time at one hourly rate, as the Model must bill it.
+/////////////////////////////////////////////////////////////////////////////
+static uint64_t refMilliCost(const uint64_t milliHourly, const uint64_t secs) {
+  return milliHourly * secs / 3600;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Creates a Model at T0, with no attendees yet.
+/////////////////////////////////////////////////////////////////////////////
+static Model* newModel() {
+  host_setTime(T0, 0);
+  return Model_create();
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// The total meeting cost, in thousandths.
+/////////////////////////////////////////////////////////////////////////////
+static uint64_t milliCost(Model* model) {
+  Model_Summary summary;
+  CHECK(Model_getSummary(model, &summary) == MPA_SUCCESS);
+  return summary.milliCost;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+static void test_localeDefaults() {
+  uint32_t rate = 0;
+  char* currSym = NULL;
+
+  host_setLocale("en_US");
+  Model* model = newModel();
+  Model_getDefaultMilliHourly(model, &rate);
+  Model_getCurrencySymbol(model, &currSym);
+  CHECK_EQ_U64(rate, 19230);
+  CHECK(strcmp(currSym, "$") == 0);
+  Model_destroy(model);
+
+  host_setLocale("de_DE");
+  model = newModel();
+  currSym = NULL;
+  Model_getDefaultMilliHourly(model, &rate);
+  Model_getCurrencySymbol(model, &currSym);
+  CHECK_EQ_U64(rate, 9615);
+  CHECK(strcmp(currSym, "€") == 0);
+  Model_destroy(model);
+  host_setLocale("en_US");
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Model_calculateCost bills exactly floor(rate * secs / 3600), whether
+/// the time passes one tick at a time or all at once.
+/////////////////////////////////////////////////////////////////////////////
+static void test_calculateCostExact() {
+  static const uint32_t rates[] = { 1, 3599, 3600, 19230, 50000, 1234567 };
+
+  for (size_t idx=0; idx<ARRAY_LENGTH(rates); idx++) {
+    Model* ticked = newModel();
+    Model* jumped = newModel();
+    CHECK(Model_adjustAttendance(ticked, 3, rates[idx]) == MPA_SUCCESS);
+    CHECK(Model_adjustAttendance(jumped, 3, rates[idx]) == MPA_SUCCESS);
+
+    for (uint32_t secs=1; secs<=7200; secs++) {
+      host_setTime(T0 + secs, 0);
+      CHECK(Model_updateTime(ticked, NULL, SECOND_UNIT) == MPA_SUCCESS);
+      if ( (secs % 997) == 0 ) {
+        CHECK(Model_updateTime(jumped, NULL, SECOND_UNIT) == MPA_SUCCESS);
+        CHECK_EQ_U64(milliCost(jumped), refMilliCost(3ull * rates[idx], secs));
+      }
+    }
+    CHECK_EQ_U64(milliCost(ticked), refMilliCost(3ull * rates[idx], 7200));
+    Model_destroy(ticked);
+    Model_destroy(jumped);
+  }
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Cost is frozen while the meeting is stopped, and resumes from there.
+/////////////////////////////////////////////////////////////////////////////
+static void test_stopStart() {
+  Model* model = newModel();
+  Model_adjustAttendance(model, 2, 36000);
+
+  host_setTime(T0 + 100, 0);
+  CHECK(Model_stopMeeting(model) == MPA_SUCCESS);
+  CHECK_EQ_U64(milliCost(model), 2000);
+
+  host_setTime(T0 + 5000, 0);
+  Model_updateTime(model, NULL, SECOND_UNIT);
+  CHECK_EQ_U64(milliCost(model), 2000);
+
+  CHECK(Model_startMeeting(model) == MPA_SUCCESS);
+  host_setTime(T0 + 5050, 0);
+  Model_updateTime(model, NULL, SECOND_UNIT);
+  CHECK_EQ_U64(milliCost(model), 3000);
+
+  Model_Summary summary;
+  Model_getSummary(model, &summary);
+  CHECK_EQ_U64(summary.durationSecs, 150);
+  CHECK_EQ_U64(summary.peakAttendees, 2);
+  Model_destroy(model);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// A wall clock set backwards doesn't bill negative time.
+/////////////////////////////////////////////////////////////////////////////
+static void test_clockBackwards() {
+  Model* model = newModel();
+  Model_adjustAttendance(model, 1, 3600);
+
+  host_setTime(T0 + 10, 0);
+  Model_updateTime(model, NULL, SECOND_UNIT);
+  CHECK_EQ_U64(milliCost(model), 10);
+
+  host_setTime(T0 - 500, 0);
+  CHECK(Model_updateTime(model, NULL, SECOND_UNIT) == MPA_SUCCESS);
+  CHECK_EQ_U64(milliCost(model), 0);
+
+  host_setTime(T0 + 20, 0);
+  Model_updateTime(model, NULL, SECOND_UNIT);
+  CHECK_EQ_U64(milliCost(model), 20);
+  Model_destroy(model);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// The displayed cost changes exactly at Model_getNextVisibleChange.
+/////////////////////////////////////////////////////////////////////////////
+static void test_nextVisibleChange() {
+  Model* model = newModel();
+  Model_adjustAttendance(model, 1, 19230);
+
+  for (int step=0; step<50; step++) {
+    time_t changeTS = 0, now = 0;
+    uint64_t before = 0, after = 0;
+    CHECK(Model_getNextVisibleChange(model, &changeTS) == MPA_SUCCESS);
+    Model_getTime(model, &now, NULL);
+    CHECK(changeTS > now);
+
+    host_setTime(changeTS - 1, 0);
+    Model_updateTime(model, NULL, SECOND_UNIT);
+    Model_getCentiMeetingCost(model, &before);
+    host_setTime(changeTS, 0);
+    Model_updateTime(model, NULL, SECOND_UNIT);
+    Model_getCentiMeetingCost(model, &after);
+    CHECK(after > before);
+  }
+  Model_destroy(model);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+static void test_fmtdCost() {
+  Model* model = newModel();
+  Model_adjustAttendance(model, 1, 3600000);
+  host_setTime(T0 + 4, 0);
+  Model_updateTime(model, NULL, SECOND_UNIT);
+
+  char fmtd[FMTD_COST_SZ];
+  CHECK(Model_getFmtdMeetingCost(model, fmtd, sizeof(fmtd)) == MPA_SUCCESS);
+  CHECK(strcmp(fmtd, "$4.00") == 0);
+  CHECK(Model_getFmtdMeetingCost(model, fmtd, 4) == MPA_STRING_ERR);
+  Model_destroy(model);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Sums the segments of a breakdown.
+/////////////////////////////////////////////////////////////////////////////
+typedef struct BreakdownSum {
+  size_t   count;
+  uint32_t secs;
+  uint64_t milliCost;
+} BreakdownSum;
+
+static bool sumSegment(const Journal_Segment* segment, void* context) {
+  BreakdownSum* sum = (BreakdownSum*)context;
+  sum->count++;
+  sum->secs += segment->secs;
+  sum->milliCost += segment->milliCost;
+  return true;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// The breakdown adds up to the meeting's cost, whether or not the journal
+/// has had to fold its oldest entries away.
+/////////////////////////////////////////////////////////////////////////////
+static void test_breakdown() {
+  Model* model = newModel();
+  Model_adjustAttendance(model, 2, 36000);
+  host_setTime(T0 + 100, 0);
+  Model_stopMeeting(model);
+  host_setTime(T0 + 200, 0);
+  Model_startMeeting(model);
+  host_setTime(T0 + 300, 0);
+  Model_adjustAttendance(model, 1, 3600);
+  host_setTime(T0 + 360, 0);
+
+  uint64_t folded = 99;
+  BreakdownSum sum = { 0 };
+  CHECK(Model_getBreakdown(model, &folded, sumSegment, &sum) == MPA_SUCCESS);
+  CHECK_EQ_U64(folded, 0);
+  CHECK_EQ_U64(sum.count, 3);
+  CHECK_EQ_U64(sum.secs, 260);
+  CHECK_EQ_U64(sum.milliCost, milliCost(model));
+  CHECK_EQ_U64(milliCost(model), 2000 + 2000 + 1260);
+  CHECK(Model_getBreakdown(model, NULL, NULL, NULL) == MPA_NULL_POINTER_ERR);
+
+  for (int idx=0; idx<100; idx++) {
+    host_advanceTime(7);
+    Model_adjustAttendance(model, (idx % 2) ? -1 : 1, 1800);
+  }
+  memset(&sum, 0, sizeof(sum));
+  CHECK(Model_getBreakdown(model, &folded, sumSegment, &sum) == MPA_SUCCESS);
+  CHECK(folded > 0);
+  CHECK(sum.count < 100);
+  CHECK_EQ_U64(folded + sum.milliCost, milliCost(model));
+
+  // A reset discards the breakdown with the meeting.
+  Model_reset(model);
+  memset(&sum, 0, sizeof(sum));
+  Model_getBreakdown(model, &folded, sumSegment, &sum);
+  CHECK_EQ_U64(folded, 0);
+  CHECK_EQ_U64(sum.count, 0);
+  Model_destroy(model);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// A restored meeting carries on from its checkpoint: its journal starts
+/// there, with the cost so far folded into it.
+/////////////////////////////////////////////////////////////////////////////
+static void test_restoreCheckpoint() {
+  Model* model = newModel();
+  Model_adjustAttendance(model, 1, 36000);
+  host_setTime(T0 + 100, 0);
+  Model_adjustAttendance(model, 1, 36000);
+  Model_Checkpoint checkpoint;
+  CHECK(Model_getCheckpoint(model, &checkpoint) == MPA_SUCCESS);
+  Model_destroy(model);
+
+  host_setTime(T0 + 400, 0);
+  Model* restored = Model_create();
+  CHECK(Model_restoreCheckpoint(restored, &checkpoint) == MPA_SUCCESS);
+  CHECK_EQ_U64(milliCost(restored), 1000 + 6000);
+
+  uint64_t folded = 0;
+  BreakdownSum sum = { 0 };
+  Model_getBreakdown(restored, &folded, sumSegment, &sum);
+  CHECK_EQ_U64(folded, 1000);
+  CHECK_EQ_U64(sum.count, 1);
+  CHECK_EQ_U64(sum.secs, 300);
+
+  // Events after the restore are journaled as usual.
+  Model_stopMeeting(restored);
+  host_setTime(T0 + 1000, 0);
+  CHECK_EQ_U64(milliCost(restored), 7000);
+  Model_Summary summary;
+  Model_getSummary(restored, &summary);
+  CHECK_EQ_U64(summary.durationSecs, 400);
+
+  checkpoint.status = LAST_MODEL_STATE;
+  CHECK(Model_restoreCheckpoint(restored, &checkpoint) == MPA_INVALID_INPUT_ERR);
+  CHECK_EQ_U64(milliCost(restored), 7000);
+  Model_destroy(restored);
+}
+
+
+int main() {
+  test_localeDefaults();
+  test_calculateCostExact();
+  test_stopStart();
+  test_clockBackwards();
+  test_nextVisibleChange();
+  test_fmtdCost();
+  test_breakdown();
+  test_restoreCheckpoint();
+  return CHECK_DONE();
+}
@@ -0,0 +1,85 @@
+#include <pebble.h>
+#include "check.h"
+
+#include "libs/PublishGate.h"
+
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+static void test_create() {
+  PublishGate* gate = PublishGate_create();
+  CHECK(gate != NULL);
+  uint32_t heldBack = 99;
+  CHECK(PublishGate_getHeldBack(gate, &heldBack) == MPA_SUCCESS);
+  CHECK_EQ_U64(heldBack, 0);
+  CHECK(PublishGate_pass(gate, 0x1, NULL) == MPA_NULL_POINTER_ERR);
+  PublishGate_destroy(gate);
+
+  uint32_t publish = 0x5;
+  CHECK(PublishGate_pass(NULL, 0x1, &publish) == MPA_NULL_POINTER_ERR);
+  CHECK_EQ_U64(publish, 0x5);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// An open gate lets every change straight through, and counts nothing.
+/////////////////////////////////////////////////////////////////////////////
+static void test_openPassesThrough() {
+  PublishGate* gate = PublishGate_create();
+  uint32_t publish = 0, heldBack = 0;
+
+  CHECK(PublishGate_pass(gate, 0x3, &publish) == MPA_SUCCESS);
+  CHECK_EQ_U64(publish, 0x3);
+  CHECK(PublishGate_pass(gate, 0, &publish) == MPA_SUCCESS);
+  CHECK_EQ_U64(publish, 0);
+
+  PublishGate_getHeldBack(gate, &heldBack);
+  CHECK_EQ_U64(heldBack, 0);
+  PublishGate_destroy(gate);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// A closed gate publishes nothing, and counts each offer of changes. Once
+/// it is open again, everything held back passes with the next offer, even
+/// an empty one.
+/////////////////////////////////////////////////////////////////////////////
+static void test_closedHoldsBack() {
+  PublishGate* gate = PublishGate_create();
+  uint32_t publish = 0, heldBack = 0;
+
+  CHECK(PublishGate_setOpen(gate, false) == MPA_SUCCESS);
+  CHECK(PublishGate_pass(gate, 0x1, &publish) == MPA_SUCCESS);
+  CHECK_EQ_U64(publish, 0);
+  PublishGate_pass(gate, 0x1, &publish);
+  PublishGate_pass(gate, 0x4, &publish);
+  CHECK_EQ_U64(publish, 0);
+  // Nothing changed, so nothing was held back.
+  PublishGate_pass(gate, 0, &publish);
+  PublishGate_getHeldBack(gate, &heldBack);
+  CHECK_EQ_U64(heldBack, 3);
+
+  CHECK(PublishGate_setOpen(gate, true) == MPA_SUCCESS);
+  CHECK(PublishGate_pass(gate, 0, &publish) == MPA_SUCCESS);
+  CHECK_EQ_U64(publish, 0x5);
+  PublishGate_pass(gate, 0x2, &publish);
+  CHECK_EQ_U64(publish, 0x2);
+
+  // The count keeps going across focus changes.
+  PublishGate_setOpen(gate, false);
+  PublishGate_pass(gate, 0x2, &publish);
+  PublishGate_setOpen(gate, true);
+  PublishGate_pass(gate, 0x8, &publish);
+  CHECK_EQ_U64(publish, 0xA);
+  PublishGate_getHeldBack(gate, &heldBack);
+  CHECK_EQ_U64(heldBack, 4);
+  PublishGate_destroy(gate);
+}
+
+
+int main() {
+  test_create();
+  test_openPassesThrough();
+  test_closedHoldsBack();
+  return CHECK_DONE();
+}
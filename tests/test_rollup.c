@@ -0,0 +1,84 @@
+#include <pebble.h>
+#include "check.h"
+#include "pebble_host.h"
+
+#include "data/Rollup.h"
+
+#define T0 1500000000
+#define DAY 86400
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Meetings in one currency add up, and survive a relaunch.
+/////////////////////////////////////////////////////////////////////////////
+static void test_totals() {
+  host_clearPersist();
+  Rollup* rollup = Rollup_create();
+  CHECK(Rollup_addMeeting(rollup, T0, 1800, 38460, "$") == MPA_SUCCESS);
+  CHECK(Rollup_addMeeting(rollup, T0 + 3600, 900, 9615, "$") == MPA_SUCCESS);
+  Rollup_destroy(rollup);
+
+  rollup = Rollup_create();
+  Rollup_Bucket current, previous;
+  CHECK(Rollup_get(rollup, ROLLUP_PERIOD_DAY, T0 + 7200, &current, &previous) == MPA_SUCCESS);
+  CHECK_EQ_U64(current.milliCost, 38460 + 9615);
+  CHECK_EQ_U64(current.meetingSecs, 1800 + 900);
+  CHECK_EQ_U64(current.numMeetings, 2);
+  CHECK_EQ_U64(previous.numMeetings, 0);
+
+  const char* currSym = NULL;
+  CHECK(Rollup_getCurrencySymbol(rollup, &currSym) == MPA_SUCCESS);
+  CHECK(strcmp(currSym, "$") == 0);
+
+  // The next day, yesterday's meetings are the previous bucket.
+  CHECK(Rollup_addMeeting(rollup, T0 + DAY, 600, 5000, "$") == MPA_SUCCESS);
+  CHECK(Rollup_get(rollup, ROLLUP_PERIOD_DAY, T0 + DAY, &current, &previous) == MPA_SUCCESS);
+  CHECK_EQ_U64(current.milliCost, 5000);
+  CHECK_EQ_U64(previous.milliCost, 38460 + 9615);
+  Rollup_destroy(rollup);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// A meeting in another currency starts every total over, in its currency,
+/// rather than adding up costs that can't be added.
+/////////////////////////////////////////////////////////////////////////////
+static void test_currencyChange() {
+  host_clearPersist();
+  Rollup* rollup = Rollup_create();
+  Rollup_addMeeting(rollup, T0 - DAY, 1800, 38460, "$");
+  Rollup_addMeeting(rollup, T0, 1800, 38460, "$");
+  CHECK(Rollup_addMeeting(rollup, T0 + 3600, 900, 9615, "€") == MPA_SUCCESS);
+
+  Rollup_Bucket current, previous;
+  for (int period=0; period<LAST_ROLLUP_PERIOD; period++) {
+    CHECK(Rollup_get(rollup, (Rollup_Period)period, T0 + 3600, &current, &previous) == MPA_SUCCESS);
+    CHECK_EQ_U64(current.milliCost, 9615);
+    CHECK_EQ_U64(current.numMeetings, 1);
+    CHECK_EQ_U64(previous.numMeetings, 0);
+  }
+  const char* currSym = NULL;
+  Rollup_getCurrencySymbol(rollup, &currSym);
+  CHECK(strcmp(currSym, "€") == 0);
+  Rollup_destroy(rollup);
+
+  rollup = Rollup_create();
+  Rollup_getCurrencySymbol(rollup, &currSym);
+  CHECK(strcmp(currSym, "€") == 0);
+
+  // A symbol longer than is kept compares as its kept part.
+  CHECK(Rollup_addMeeting(rollup, T0 + 7200, 60, 100, "ABCDEFGHIJ") == MPA_SUCCESS);
+  CHECK(Rollup_addMeeting(rollup, T0 + 7300, 60, 100, "ABCDEFGHIJ") == MPA_SUCCESS);
+  Rollup_get(rollup, ROLLUP_PERIOD_DAY, T0 + 7300, &current, NULL);
+  CHECK_EQ_U64(current.numMeetings, 2);
+  Rollup_getCurrencySymbol(rollup, &currSym);
+  CHECK_EQ_U64(strlen(currSym), ROLLUP_CURRENCY_SZ - 1);
+  Rollup_destroy(rollup);
+}
+
+
+int main() {
+  test_totals();
+  test_currencyChange();
+  return CHECK_DONE();
+}
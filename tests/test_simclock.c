@@ -0,0 +1,251 @@
+#include <pebble.h>
+#include "check.h"
+#include "bench.h"
+
+#include "data/Model.h"
+
+// Meetings run on a simulated clock registered with Model_setClock, so
+// hours of meeting time replay in moments. Costs are checked against a
+// reference computed independently of the Model.
+
+#define T0 1500000000
+
+static time_t simSecs;
+static uint16_t simMs;
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// The simulated clock.
+/////////////////////////////////////////////////////////////////////////////
+static time_t simClock(uint16_t* ms) {
+  if (ms != NULL) *ms = simMs;
+  return simSecs;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Reference cost: the Model bills each stretch at one rate separately,
+/// rounded down to whole thousandths, and freezes it when the rate changes.
+/////////////////////////////////////////////////////////////////////////////
+typedef struct RefMeeting {
+  bool     running;
+  uint32_t milliHourly;       ///< total rate
+  time_t   segmentStartTS;
+  uint64_t frozenMilliCost;   ///< cost of the finished stretches
+  uint64_t exactRateSecs;     ///< sum of rate * seconds over every stretch, unrounded
+} RefMeeting;
+
+static void ref_closeSegment(RefMeeting* ref, const time_t now) {
+  if (ref->running && (now > ref->segmentStartTS)) {
+    uint64_t rateSecs = (uint64_t)ref->milliHourly * (uint64_t)(now - ref->segmentStartTS);
+    ref->frozenMilliCost += rateSecs / 3600;
+    ref->exactRateSecs += rateSecs;
+  }
+  ref->segmentStartTS = now;
+}
+
+static uint64_t ref_milliCost(const RefMeeting* ref, const time_t now) {
+  uint64_t cost = ref->frozenMilliCost;
+  if (ref->running && (now > ref->segmentStartTS)) cost += (uint64_t)ref->milliHourly * (uint64_t)(now - ref->segmentStartTS) / 3600;
+  return cost;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Creates a Model on the simulated clock, at T0.
+/////////////////////////////////////////////////////////////////////////////
+static Model* newSimModel() {
+  simSecs = T0;
+  simMs = 0;
+  Model* model = Model_create();
+  CHECK(Model_setClock(model, simClock) == MPA_SUCCESS);
+  return model;
+}
+
+static uint64_t milliCost(Model* model) {
+  Model_Summary summary;
+  CHECK(Model_getSummary(model, &summary) == MPA_SUCCESS);
+  return summary.milliCost;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// An 8-hour meeting, with people joining and leaving at odd times.
+/////////////////////////////////////////////////////////////////////////////
+static void test_multiHourMeeting() {
+  Model* model = newSimModel();
+
+  static const struct { uint32_t atSecs; int16_t attendees; uint32_t milliHourly; } events[] = {
+    {     0,  4, 19230 },
+    {   917,  2, 50000 },
+    {  3601, -1, 19230 },
+    { 10007,  6, 33333 },
+    { 17999, -3, 33333 },
+    { 24000,  1,  7777 },
+  };
+  uint64_t expected = 0;
+  uint32_t rate = 0, lastTS = 0;
+  for (size_t idx=0; idx<ARRAY_LENGTH(events); idx++) {
+    expected += (uint64_t)rate * (events[idx].atSecs - lastTS) / 3600;
+    simSecs = T0 + events[idx].atSecs;
+    CHECK(Model_adjustAttendance(model, events[idx].attendees, events[idx].milliHourly) == MPA_SUCCESS);
+    rate += events[idx].attendees * events[idx].milliHourly;
+    lastTS = events[idx].atSecs;
+  }
+  expected += (uint64_t)rate * (8 * 3600 - lastTS) / 3600;
+
+  simSecs = T0 + 8 * 3600;
+  Model_updateTime(model, NULL, SECOND_UNIT);
+  CHECK_EQ_U64(milliCost(model), expected);
+
+  Model_Summary summary;
+  Model_getSummary(model, &summary);
+  CHECK_EQ_U64(summary.durationSecs, 8 * 3600);
+  CHECK_EQ_U64(summary.peakAttendees, 11);
+  Model_destroy(model);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Paused time is not billed, nor counted in the duration.
+/////////////////////////////////////////////////////////////////////////////
+static void test_pauseResume() {
+  Model* model = newSimModel();
+  Model_adjustAttendance(model, 3, 19230);
+
+  simSecs = T0 + 1234;
+  CHECK(Model_stopMeeting(model) == MPA_SUCCESS);
+  uint64_t atPause = 3ull * 19230 * 1234 / 3600;
+  CHECK_EQ_U64(milliCost(model), atPause);
+
+  simSecs = T0 + 1234 + 7200;
+  Model_updateTime(model, NULL, SECOND_UNIT);
+  CHECK_EQ_U64(milliCost(model), atPause);
+
+  CHECK(Model_startMeeting(model) == MPA_SUCCESS);
+  simSecs += 600;
+  Model_updateTime(model, NULL, SECOND_UNIT);
+  CHECK_EQ_U64(milliCost(model), atPause + 3ull * 19230 * 600 / 3600);
+
+  Model_Summary summary;
+  Model_getSummary(model, &summary);
+  CHECK_EQ_U64(summary.durationSecs, 1234 + 600);
+  CHECK_EQ_U64(summary.startTS, T0);
+  Model_destroy(model);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// A rate change takes effect at the second the clock shows, whatever its
+/// milliseconds: the Model bills whole seconds, so the cost never differs
+/// from the continuous cost by more than one second at the changed rate.
+/////////////////////////////////////////////////////////////////////////////
+static void test_changeMidSecond() {
+  Model* model = newSimModel();
+  Model_adjustAttendance(model, 1, 36000);
+
+  simSecs = T0 + 10;
+  simMs = 500;
+  Model_adjustAttendance(model, 9, 36000);
+
+  simSecs = T0 + 20;
+  simMs = 0;
+  Model_updateTime(model, NULL, SECOND_UNIT);
+  uint64_t billed = milliCost(model);
+  CHECK_EQ_U64(billed, 10 * 10 + 10 * 100);
+
+  // 10.5 s at 10/s, then 9.5 s at 100/s
+  uint64_t continuous = 105 + 950;
+  uint64_t oneSecondOfChange = 100 - 10;
+  CHECK( (billed > continuous ? billed - continuous : continuous - billed) <= oneSecondOfChange );
+  Model_destroy(model);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Adds a segment's cost to the total in the context.
+/////////////////////////////////////////////////////////////////////////////
+static bool sumSegment(const Journal_Segment* segment, void* context) {
+  *(uint64_t*)context += segment->milliCost;
+  return true;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Replays a full day of random joins, leaves and pauses, checking the
+/// cost after every event against the reference, and reports the
+/// throughput and how far the billed cost strays from the unrounded cost.
+/////////////////////////////////////////////////////////////////////////////
+static void test_simulatedDay() {
+  Model* model = newSimModel();
+  RefMeeting ref = { 0 };
+  uint16_t attendees = 0;
+  uint32_t numEvents = 0, numSegments = 0;
+  srand(20261018);
+
+  uint64_t startNs = bench_nowNs();
+  while (simSecs < T0 + 24 * 3600) {
+    simSecs += 1 + rand() % 120;
+    simMs = (uint16_t)(rand() % 1000);
+    int action = rand() % 10;
+
+    if ( (action < 5) || (attendees == 0) ) {
+      int16_t joining = (int16_t)(1 + rand() % 5);
+      uint32_t milliHourly = 5000 + (uint32_t)(rand() % 200000);
+      ref_closeSegment(&ref, simSecs);
+      CHECK(Model_adjustAttendance(model, joining, milliHourly) == MPA_SUCCESS);
+      attendees += joining;
+      ref.milliHourly += joining * milliHourly;
+      ref.running = true;
+      // Leave again with the same rate later
+      if (rand() % 2) {
+        simSecs += 1 + rand() % 600;
+        ref_closeSegment(&ref, simSecs);
+        CHECK(Model_adjustAttendance(model, -joining, milliHourly) == MPA_SUCCESS);
+        attendees -= joining;
+        ref.milliHourly -= joining * milliHourly;
+        ref.running = (attendees > 0);
+        numSegments++;
+      }
+    } else if ( (action < 7) && ref.running ) {
+      ref_closeSegment(&ref, simSecs);
+      CHECK(Model_stopMeeting(model) == MPA_SUCCESS);
+      ref.running = false;
+    } else if ( (action < 9) && !ref.running ) {
+      ref_closeSegment(&ref, simSecs);
+      CHECK(Model_startMeeting(model) == MPA_SUCCESS);
+      ref.running = true;
+    } else {
+      CHECK(Model_updateTime(model, NULL, SECOND_UNIT) == MPA_SUCCESS);
+    }
+    numEvents++;
+    numSegments++;
+    CHECK_EQ_U64(milliCost(model), ref_milliCost(&ref, simSecs));
+  }
+  uint64_t elapsedNs = bench_nowNs() - startNs;
+
+  ref_closeSegment(&ref, simSecs);
+  uint64_t billed = milliCost(model);
+  uint64_t unrounded = ref.exactRateSecs / 3600;
+  CHECK(billed <= unrounded);
+  CHECK(unrounded - billed <= numSegments);
+
+  // The journal's breakdown adds up to the same bill.
+  uint64_t folded = 0, brokenDown = 0;
+  CHECK(Model_getBreakdown(model, &folded, sumSegment, &brokenDown) == MPA_SUCCESS);
+  CHECK_EQ_U64(folded + brokenDown, billed);
+
+  printf("simulated day: %lu events in %.2f ms (%.0f events/s); billed %llu, unrounded %llu thousandths (%llu apart over %lu rate segments)\n",
+         (unsigned long)numEvents, elapsedNs / 1e6, numEvents / (elapsedNs / 1e9),
+         (unsigned long long)billed, (unsigned long long)unrounded, (unsigned long long)(unrounded - billed), (unsigned long)numSegments);
+  Model_destroy(model);
+}
+
+
+int main() {
+  test_multiHourMeeting();
+  test_pauseResume();
+  test_changeMidSecond();
+  test_simulatedDay();
+  return CHECK_DONE();
+}
@@ -0,0 +1,126 @@
+#include <pebble.h>
+#include "check.h"
+
+#include "libs/SlotQueue.h"
+
+typedef struct TestSlot {
+  uint32_t id;
+  uint8_t  payload[12];
+} TestSlot;
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Writes a slot holding the given id.
+/////////////////////////////////////////////////////////////////////////////
+static MagPebApp_ErrCode writeId(SlotQueue* queue, const SlotQueue_FullPolicy policy, const uint32_t id, bool* dropped) {
+  void* slot = NULL;
+  MagPebApp_ErrCode mpaRet = SlotQueue_write(queue, policy, &slot, dropped);
+  if (mpaRet == MPA_SUCCESS) ((TestSlot*)slot)->id = id;
+  return mpaRet;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Gets the id in the slot at a position, or 0 if there is none.
+/////////////////////////////////////////////////////////////////////////////
+static uint32_t idAt(SlotQueue* queue, const size_t index) {
+  void* slot = NULL;
+  if (SlotQueue_peekAt(queue, index, &slot) != MPA_SUCCESS) return 0;
+  return ((TestSlot*)slot)->id;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+static void test_create() {
+  CHECK(SlotQueue_create(0, sizeof(TestSlot)) == NULL);
+  CHECK(SlotQueue_create(4, 0) == NULL);
+
+  SlotQueue* queue = SlotQueue_create(4, sizeof(TestSlot));
+  CHECK(queue != NULL);
+  size_t count = 99;
+  CHECK(SlotQueue_count(queue, &count) == MPA_SUCCESS);
+  CHECK_EQ_U64(count, 0);
+  CHECK(SlotQueue_drop(queue) == MPA_EMPTY_ERR);
+  void* slot = (void*)1;
+  CHECK(SlotQueue_peekAt(queue, 0, &slot) == MPA_EMPTY_ERR);
+  CHECK(slot == NULL);
+  SlotQueue_destroy(queue);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// Slots come out in the order they went in, across the wrap of the arena.
+/////////////////////////////////////////////////////////////////////////////
+static void test_fifoWraps() {
+  SlotQueue* queue = SlotQueue_create(3, sizeof(TestSlot));
+  uint32_t nextIn = 1, nextOut = 1;
+  size_t count = 0;
+
+  for (int round=0; round<10; round++) {
+    CHECK(writeId(queue, SLOTQUEUE_REJECT_NEW, nextIn++, NULL) == MPA_SUCCESS);
+    CHECK(writeId(queue, SLOTQUEUE_REJECT_NEW, nextIn++, NULL) == MPA_SUCCESS);
+    SlotQueue_count(queue, &count);
+    CHECK_EQ_U64(count, 2);
+    CHECK_EQ_U64(idAt(queue, 0), nextOut);
+    CHECK_EQ_U64(idAt(queue, 1), nextOut + 1);
+    CHECK_EQ_U64(idAt(queue, 2), 0);
+    CHECK(SlotQueue_drop(queue) == MPA_SUCCESS);
+    CHECK(SlotQueue_drop(queue) == MPA_SUCCESS);
+    nextOut += 2;
+  }
+  SlotQueue_count(queue, &count);
+  CHECK_EQ_U64(count, 0);
+  SlotQueue_destroy(queue);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// A full queue either refuses the new slot or drops the oldest one.
+/////////////////////////////////////////////////////////////////////////////
+static void test_fullPolicies() {
+  SlotQueue* queue = SlotQueue_create(2, sizeof(TestSlot));
+  bool dropped = true;
+
+  CHECK(writeId(queue, SLOTQUEUE_REJECT_NEW, 1, &dropped) == MPA_SUCCESS);
+  CHECK(!dropped);
+  CHECK(writeId(queue, SLOTQUEUE_REJECT_NEW, 2, &dropped) == MPA_SUCCESS);
+
+  void* slot = (void*)1;
+  CHECK(SlotQueue_write(queue, SLOTQUEUE_REJECT_NEW, &slot, &dropped) == MPA_FULL_ERR);
+  CHECK(slot == NULL);
+  CHECK(!dropped);
+  CHECK_EQ_U64(idAt(queue, 0), 1);
+
+  CHECK(writeId(queue, SLOTQUEUE_DROP_OLDEST, 3, &dropped) == MPA_SUCCESS);
+  CHECK(dropped);
+  CHECK_EQ_U64(idAt(queue, 0), 2);
+  CHECK_EQ_U64(idAt(queue, 1), 3);
+  SlotQueue_destroy(queue);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// A reused slot comes back zero-filled, not with the old contents.
+/////////////////////////////////////////////////////////////////////////////
+static void test_slotsZeroed() {
+  SlotQueue* queue = SlotQueue_create(1, sizeof(TestSlot));
+  void* slot = NULL;
+  SlotQueue_write(queue, SLOTQUEUE_REJECT_NEW, &slot, NULL);
+  memset(slot, 0xAB, sizeof(TestSlot));
+  SlotQueue_drop(queue);
+
+  SlotQueue_write(queue, SLOTQUEUE_REJECT_NEW, &slot, NULL);
+  static const TestSlot zero;
+  CHECK(memcmp(slot, &zero, sizeof(zero)) == 0);
+  SlotQueue_destroy(queue);
+}
+
+
+int main() {
+  test_create();
+  test_fifoWraps();
+  test_fullPolicies();
+  test_slotsZeroed();
+  return CHECK_DONE();
+}